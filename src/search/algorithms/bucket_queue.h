@@ -0,0 +1,259 @@
+#ifndef ALGORITHMS_BUCKET_QUEUE_H
+#define ALGORITHMS_BUCKET_QUEUE_H
+
+#include "../utils/hash.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+/*
+  BucketQueue is a priority queue for values with keys that are vectors of
+  non-negative ints of a fixed dimension. Values are removed in
+  lexicographic order of their keys and in FIFO order among equal keys,
+  i.e., it behaves like a map from keys to deques, but avoids the tree walks
+  and deque allocations of such a map.
+
+  Each key component is handled by one level of buckets: the buckets of the
+  first level are indexed by the first key component and contain a level of
+  buckets for the second component and so on. The buckets of the last level
+  hold the values. A level stores its buckets in a vector indexed by the key
+  (dense mode) until a key reaches max_dense_key. From then on, the level
+  stores its non-empty buckets in a hash map and the keys of these buckets
+  in a radix heap (sparse mode), so large keys such as f-values with high
+  action costs do not lead to huge bucket vectors.
+*/
+
+namespace bucket_queue {
+/*
+  Min-heap of distinct non-negative ints. A radix heap assumes that pushed
+  keys are never smaller than the last key removed, which holds for the
+  f-values of A* with consistent heuristics. Pushing a smaller key is still
+  supported, but rebuilds the heap.
+*/
+class RadixHeap {
+    static const int NUM_BUCKETS = 33;
+
+    // Bucket i > 0 holds the keys whose highest bit differing from last is i-1.
+    std::vector<std::vector<unsigned int>> buckets;
+    unsigned int last;
+    int num_keys;
+
+    static int get_bucket(unsigned int key, unsigned int last) {
+        return key == last ? 0 : 32 - std::countl_zero(key ^ last);
+    }
+
+    void redistribute(std::vector<unsigned int> &keys) {
+        std::vector<unsigned int> moved_keys;
+        moved_keys.swap(keys);
+        for (unsigned int key : moved_keys) {
+            buckets[get_bucket(key, last)].push_back(key);
+        }
+    }
+
+    // Moves the smallest key to bucket 0.
+    void refill() {
+        assert(num_keys > 0);
+        if (!buckets[0].empty()) {
+            return;
+        }
+        int i = 1;
+        while (buckets[i].empty()) {
+            ++i;
+        }
+        last = *std::min_element(buckets[i].begin(), buckets[i].end());
+        redistribute(buckets[i]);
+    }
+
+    void rebuild(unsigned int new_last) {
+        std::vector<unsigned int> keys;
+        for (std::vector<unsigned int> &bucket : buckets) {
+            keys.insert(keys.end(), bucket.begin(), bucket.end());
+            bucket.clear();
+        }
+        last = new_last;
+        redistribute(keys);
+    }
+public:
+    RadixHeap()
+        : buckets(NUM_BUCKETS),
+          last(0),
+          num_keys(0) {
+    }
+
+    void push(int key) {
+        assert(key >= 0);
+        if (static_cast<unsigned int>(key) < last) {
+            rebuild(key);
+        }
+        buckets[get_bucket(key, last)].push_back(key);
+        ++num_keys;
+    }
+
+    int top() {
+        refill();
+        return buckets[0].back();
+    }
+
+    void pop() {
+        refill();
+        buckets[0].pop_back();
+        --num_keys;
+    }
+
+    bool empty() const {
+        return num_keys == 0;
+    }
+};
+
+
+template<class Value>
+class BucketQueue {
+    struct Level;
+
+    struct Bucket {
+        // Values in FIFO order (only used on the last level).
+        std::vector<Value> values;
+        size_t first_value = 0;
+        // Buckets for the next key component (only used on other levels).
+        std::unique_ptr<Level> next_level;
+    };
+
+    struct Level {
+        int size = 0;
+        bool dense = true;
+        // In dense mode, no bucket before min_key is non-empty.
+        int min_key = 0;
+        std::vector<Bucket> dense_buckets;
+        utils::HashMap<int, Bucket> sparse_buckets;
+        RadixHeap sparse_keys;
+    };
+
+    const int dimension;
+    const int max_dense_key;
+    Level first_level;
+
+    int get_bucket_size(const Bucket &bucket, int depth) const {
+        if (depth == dimension - 1) {
+            return bucket.values.size() - bucket.first_value;
+        }
+        return bucket.next_level ? bucket.next_level->size : 0;
+    }
+
+    void make_sparse(Level &level, int depth) {
+        assert(level.dense);
+        for (size_t key = 0; key < level.dense_buckets.size(); ++key) {
+            Bucket &bucket = level.dense_buckets[key];
+            if (get_bucket_size(bucket, depth) > 0) {
+                level.sparse_buckets.emplace(key, std::move(bucket));
+                level.sparse_keys.push(key);
+            }
+        }
+        level.dense_buckets = std::vector<Bucket>();
+        level.dense = false;
+    }
+
+    Bucket &get_bucket_for_insertion(Level &level, int key, int depth) {
+        if (level.dense && key >= max_dense_key) {
+            make_sparse(level, depth);
+        }
+        if (level.dense) {
+            if (key >= static_cast<int>(level.dense_buckets.size())) {
+                level.dense_buckets.resize(
+                    std::min(std::max<size_t>(key + 1, 2 * level.dense_buckets.size()),
+                             static_cast<size_t>(max_dense_key)));
+            }
+            if (level.size == 0 || key < level.min_key) {
+                level.min_key = key;
+            }
+            return level.dense_buckets[key];
+        }
+        auto [it, inserted] = level.sparse_buckets.try_emplace(key);
+        if (inserted) {
+            level.sparse_keys.push(key);
+        }
+        return it->second;
+    }
+
+    void push(Level &level, const std::vector<int> &key, int depth, const Value &value) {
+        if (key[depth] < 0) {
+            std::cerr << "Bucket queues only support non-negative keys." << std::endl;
+            utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+        Bucket &bucket = get_bucket_for_insertion(level, key[depth], depth);
+        if (depth == dimension - 1) {
+            bucket.values.push_back(value);
+        } else {
+            if (!bucket.next_level) {
+                bucket.next_level = std::make_unique<Level>();
+            }
+            push(*bucket.next_level, key, depth + 1, value);
+        }
+        ++level.size;
+    }
+
+    Value pop(Level &level, int depth) {
+        assert(level.size > 0);
+        int key = level.dense ? level.min_key : level.sparse_keys.top();
+        Bucket &bucket = level.dense ?
+            level.dense_buckets[key] : level.sparse_buckets.find(key)->second;
+        Value result = depth == dimension - 1 ?
+            bucket.values[bucket.first_value++] : pop(*bucket.next_level, depth + 1);
+        --level.size;
+        if (get_bucket_size(bucket, depth) == 0) {
+            if (depth == dimension - 1) {
+                bucket.values.clear();
+                bucket.first_value = 0;
+            } else {
+                // Deeper levels of emptied buckets are rarely reused in A*.
+                bucket.next_level.reset();
+            }
+            if (!level.dense) {
+                level.sparse_keys.pop();
+                level.sparse_buckets.erase(key);
+            } else if (level.size > 0) {
+                while (get_bucket_size(level.dense_buckets[level.min_key], depth) == 0) {
+                    ++level.min_key;
+                }
+            }
+        }
+        return result;
+    }
+public:
+    BucketQueue(int dimension, int max_dense_key)
+        : dimension(dimension),
+          max_dense_key(max_dense_key) {
+        assert(dimension >= 1);
+        assert(max_dense_key >= 1);
+    }
+
+    // The key must have the queue's dimension.
+    void push(const std::vector<int> &key, const Value &value) {
+        assert(static_cast<int>(key.size()) == dimension);
+        push(first_level, key, 0, value);
+    }
+
+    // Removes and returns the oldest value with the smallest key.
+    Value pop() {
+        return pop(first_level, 0);
+    }
+
+    bool empty() const {
+        return first_level.size == 0;
+    }
+
+    int size() const {
+        return first_level.size;
+    }
+
+    void clear() {
+        first_level = Level();
+    }
+};
+}
+
+#endif
@@ -0,0 +1,236 @@
+#ifndef ALGORITHMS_CONCURRENT_SEGMENTED_VECTOR_H
+#define ALGORITHMS_CONCURRENT_SEGMENTED_VECTOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+/*
+  ConcurrentSegmentedVector and ConcurrentSegmentedArrayVector are variants of
+  SegmentedVector and SegmentedArrayVector (see segmented_vector.h) that may
+  grow while other threads access existing elements. They only grow, i.e.,
+  there is no pop_back.
+
+  Reading an element never locks. The pointers to the segments are stored in a
+  directory that is never modified in place when it has to grow: a copy of
+  twice the size is published instead and the old directories are kept alive
+  until the vector is destroyed. Since the directories only double, the old
+  ones together never take more memory than the current one.
+
+  Synchronizing the *contents* of elements is left to the user. In particular,
+  an element added by one thread may only be read by another thread after the
+  index has been passed on in a synchronized way (e.g., through a locked data
+  structure).
+*/
+
+namespace segmented_vector {
+template<class Element>
+class SegmentDirectory {
+    struct Table {
+        size_t capacity;
+        std::unique_ptr<Element *[]> segments;
+
+        explicit Table(size_t capacity)
+            : capacity(capacity),
+              segments(new Element *[capacity]) {
+        }
+    };
+
+    std::vector<std::unique_ptr<Table>> tables;
+    std::atomic<Table *> current;
+    std::atomic<size_t> num_segments;
+public:
+    SegmentDirectory()
+        : current(nullptr),
+          num_segments(0) {
+    }
+
+    SegmentDirectory(const SegmentDirectory &) = delete;
+    SegmentDirectory &operator=(const SegmentDirectory &) = delete;
+
+    Element *operator[](size_t segment) const {
+        Table *table = current.load(std::memory_order_acquire);
+        assert(segment < table->capacity);
+        return table->segments[segment];
+    }
+
+    size_t size() const {
+        return num_segments.load(std::memory_order_acquire);
+    }
+
+    // Not thread-safe: calls must be serialized by the user.
+    void push_back(Element *segment) {
+        size_t index = num_segments.load(std::memory_order_relaxed);
+        Table *table = current.load(std::memory_order_relaxed);
+        if (!table || index == table->capacity) {
+            size_t new_capacity = table ? 2 * table->capacity : 16;
+            tables.push_back(std::make_unique<Table>(new_capacity));
+            Table *new_table = tables.back().get();
+            if (table) {
+                std::copy(table->segments.get(), table->segments.get() + index,
+                          new_table->segments.get());
+            }
+            current.store(new_table, std::memory_order_release);
+            table = new_table;
+        }
+        table->segments[index] = segment;
+        num_segments.store(index + 1, std::memory_order_release);
+    }
+};
+
+
+template<class Entry>
+class ConcurrentSegmentedVector {
+    static const size_t SEGMENT_BYTES = 8192;
+
+    static const size_t SEGMENT_ELEMENTS =
+        (SEGMENT_BYTES / sizeof(Entry)) >= 1 ?
+        (SEGMENT_BYTES / sizeof(Entry)) : 1;
+
+    std::allocator<Entry> entry_allocator;
+    SegmentDirectory<Entry> segments;
+    std::mutex growth_mutex;
+
+    ConcurrentSegmentedVector(const ConcurrentSegmentedVector<Entry> &) = delete;
+    ConcurrentSegmentedVector &operator=(const ConcurrentSegmentedVector<Entry> &) = delete;
+public:
+    ConcurrentSegmentedVector() = default;
+
+    ~ConcurrentSegmentedVector() {
+        for (size_t segment = 0; segment < segments.size(); ++segment) {
+            Entry *entries = segments[segment];
+            for (size_t offset = 0; offset < SEGMENT_ELEMENTS; ++offset) {
+                std::allocator_traits<std::allocator<Entry>>::destroy(entry_allocator, entries + offset);
+            }
+            entry_allocator.deallocate(entries, SEGMENT_ELEMENTS);
+        }
+    }
+
+    Entry &operator[](size_t index) {
+        assert(index < size());
+        return segments[index / SEGMENT_ELEMENTS][index % SEGMENT_ELEMENTS];
+    }
+
+    const Entry &operator[](size_t index) const {
+        assert(index < size());
+        return segments[index / SEGMENT_ELEMENTS][index % SEGMENT_ELEMENTS];
+    }
+
+    /*
+      The size is always a multiple of the number of entries per segment
+      because we construct whole segments at once.
+    */
+    size_t size() const {
+        return segments.size() * SEGMENT_ELEMENTS;
+    }
+
+    /*
+      Makes sure that there are at least new_size entries. New entries are
+      copies of entry. Thread-safe.
+    */
+    void grow(size_t new_size, const Entry &entry) {
+        std::lock_guard<std::mutex> lock(growth_mutex);
+        while (size() < new_size) {
+            Entry *new_segment = entry_allocator.allocate(SEGMENT_ELEMENTS);
+            for (size_t offset = 0; offset < SEGMENT_ELEMENTS; ++offset) {
+                std::allocator_traits<std::allocator<Entry>>::construct(
+                    entry_allocator, new_segment + offset, entry);
+            }
+            segments.push_back(new_segment);
+        }
+    }
+};
+
+
+/*
+  Arrays are stored without constructing or destroying their elements, so
+  we only support trivially copyable elements such as packed state bins.
+*/
+template<class Element>
+class ConcurrentSegmentedArrayVector {
+    static_assert(std::is_trivially_copyable<Element>::value,
+                  "ConcurrentSegmentedArrayVector requires trivially copyable elements");
+    static const size_t SEGMENT_BYTES = 8192;
+
+    const size_t elements_per_array;
+    const size_t arrays_per_segment;
+    const size_t elements_per_segment;
+
+    std::allocator<Element> element_allocator;
+    SegmentDirectory<Element> segments;
+    std::mutex growth_mutex;
+    std::atomic<size_t> the_size;
+
+    size_t get_segment(size_t index) const {
+        return index / arrays_per_segment;
+    }
+
+    size_t get_offset(size_t index) const {
+        return (index % arrays_per_segment) * elements_per_array;
+    }
+
+    void ensure_segment_exists(size_t segment) {
+        if (segment < segments.size()) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(growth_mutex);
+        while (segments.size() <= segment) {
+            segments.push_back(element_allocator.allocate(elements_per_segment));
+        }
+    }
+
+    ConcurrentSegmentedArrayVector(const ConcurrentSegmentedArrayVector<Element> &) = delete;
+    ConcurrentSegmentedArrayVector &operator=(const ConcurrentSegmentedArrayVector<Element> &) = delete;
+public:
+    explicit ConcurrentSegmentedArrayVector(size_t elements_per_array_)
+        : elements_per_array((assert(elements_per_array_ > 0),
+                              elements_per_array_)),
+          arrays_per_segment(
+              std::max(SEGMENT_BYTES / (elements_per_array * sizeof(Element)), size_t (1))),
+          elements_per_segment(elements_per_array * arrays_per_segment),
+          the_size(0) {
+    }
+
+    ~ConcurrentSegmentedArrayVector() {
+        for (size_t segment = 0; segment < segments.size(); ++segment) {
+            element_allocator.deallocate(segments[segment], elements_per_segment);
+        }
+    }
+
+    Element *operator[](size_t index) {
+        assert(index < size());
+        return segments[get_segment(index)] + get_offset(index);
+    }
+
+    const Element *operator[](size_t index) const {
+        assert(index < size());
+        return segments[get_segment(index)] + get_offset(index);
+    }
+
+    /*
+      Returns the number of arrays added so far, including arrays that other
+      threads are still copying.
+    */
+    size_t size() const {
+        return the_size.load(std::memory_order_acquire);
+    }
+
+    /*
+      Appends a copy of the given array and returns its index. Thread-safe;
+      only the allocation of a new segment takes a lock.
+    */
+    size_t push_back(const Element *entry) {
+        size_t index = the_size.fetch_add(1, std::memory_order_acq_rel);
+        ensure_segment_exists(get_segment(index));
+        std::copy(entry, entry + elements_per_array,
+                  segments[get_segment(index)] + get_offset(index));
+        return index;
+    }
+};
+}
+
+#endif
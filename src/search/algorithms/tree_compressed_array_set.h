@@ -0,0 +1,236 @@
+#ifndef ALGORITHMS_TREE_COMPRESSED_ARRAY_SET_H
+#define ALGORITHMS_TREE_COMPRESSED_ARRAY_SET_H
+
+#include "int_hash_set.h"
+#include "segmented_vector.h"
+
+#include "../utils/hash.h"
+#include "../utils/logging.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include <vector>
+
+/*
+  TreeCompressedArraySet stores a set of equally sized arrays and assigns
+  consecutive IDs to them in the order in which they are added. It can be
+  used like a SegmentedArrayVector with duplicate detection, but stores the
+  arrays with tree compression (Köhler and Laarman style hash consing): every
+  array is split into leaves of leaf_size elements, and the leaves are the
+  bottom level of a balanced binary tree whose inner nodes are pairs of child
+  IDs. Leaves and inner nodes are stored only once in hash tables, so arrays
+  that differ in few elements share most of their tree. An array is
+  identified by the ID of its root.
+
+  Adding an array of n elements costs O(n / leaf_size) hash table lookups,
+  but if similar arrays are added, only O(log(n / leaf_size)) new tree nodes
+  per array are stored in the long run. Larger leaves make adding and
+  retrieving arrays faster and compress less.
+
+  Since equal arrays have the same root, duplicate detection only compares
+  root IDs. Retrieving an array has to walk the whole tree, so the arrays
+  cannot be accessed in place; get() copies them into a given buffer
+  instead.
+*/
+
+namespace tree_compression {
+template<class Element>
+class TreeCompressedArraySet {
+    using Node = std::pair<int, int>;
+
+    struct LeafHash {
+        const segmented_vector::SegmentedArrayVector<Element> &leaves;
+        int leaf_size;
+        LeafHash(const segmented_vector::SegmentedArrayVector<Element> &leaves, int leaf_size)
+            : leaves(leaves), leaf_size(leaf_size) {
+        }
+
+        int_hash_set::HashType operator()(int id) const {
+            const Element *leaf = leaves[id];
+            utils::HashState hash_state;
+            for (int i = 0; i < leaf_size; ++i) {
+                hash_state.feed(leaf[i]);
+            }
+            return hash_state.get_hash32();
+        }
+    };
+
+    struct LeafEqual {
+        const segmented_vector::SegmentedArrayVector<Element> &leaves;
+        int leaf_size;
+        LeafEqual(const segmented_vector::SegmentedArrayVector<Element> &leaves, int leaf_size)
+            : leaves(leaves), leaf_size(leaf_size) {
+        }
+
+        bool operator()(int lhs, int rhs) const {
+            return std::equal(leaves[lhs], leaves[lhs] + leaf_size, leaves[rhs]);
+        }
+    };
+
+    struct NodeHash {
+        const segmented_vector::SegmentedVector<Node> &nodes;
+        explicit NodeHash(const segmented_vector::SegmentedVector<Node> &nodes)
+            : nodes(nodes) {
+        }
+
+        int_hash_set::HashType operator()(int id) const {
+            utils::HashState hash_state;
+            hash_state.feed(nodes[id].first);
+            hash_state.feed(nodes[id].second);
+            return hash_state.get_hash32();
+        }
+    };
+
+    struct NodeEqual {
+        const segmented_vector::SegmentedVector<Node> &nodes;
+        explicit NodeEqual(const segmented_vector::SegmentedVector<Node> &nodes)
+            : nodes(nodes) {
+        }
+
+        bool operator()(int lhs, int rhs) const {
+            return nodes[lhs] == nodes[rhs];
+        }
+    };
+
+    struct RootHash {
+        const segmented_vector::SegmentedVector<int> &roots;
+        explicit RootHash(const segmented_vector::SegmentedVector<int> &roots)
+            : roots(roots) {
+        }
+
+        int_hash_set::HashType operator()(int id) const {
+            utils::HashState hash_state;
+            hash_state.feed(roots[id]);
+            return hash_state.get_hash32();
+        }
+    };
+
+    struct RootEqual {
+        const segmented_vector::SegmentedVector<int> &roots;
+        explicit RootEqual(const segmented_vector::SegmentedVector<int> &roots)
+            : roots(roots) {
+        }
+
+        bool operator()(int lhs, int rhs) const {
+            return roots[lhs] == roots[rhs];
+        }
+    };
+
+    const int array_size;
+    const int leaf_size;
+    const int num_leaves;
+
+    segmented_vector::SegmentedArrayVector<Element> leaves;
+    int_hash_set::IntHashSet<LeafHash, LeafEqual> leaf_ids;
+    segmented_vector::SegmentedVector<Node> nodes;
+    int_hash_set::IntHashSet<NodeHash, NodeEqual> node_ids;
+    // Maps array IDs to the IDs of their roots.
+    segmented_vector::SegmentedVector<int> roots;
+    int_hash_set::IntHashSet<RootHash, RootEqual> array_ids;
+
+    // Holds a leaf while it is added, so partial leaves can be padded.
+    std::vector<Element> leaf_buffer;
+
+    int insert_leaf(const Element *array, int leaf) {
+        int begin = leaf * leaf_size;
+        int end = std::min(begin + leaf_size, array_size);
+        std::fill(std::copy(array + begin, array + end, leaf_buffer.begin()),
+                  leaf_buffer.end(), Element());
+        leaves.push_back(leaf_buffer.data());
+        std::pair<int, bool> result = leaf_ids.insert(leaves.size() - 1);
+        if (!result.second) {
+            leaves.pop_back();
+        }
+        return result.first;
+    }
+
+    // Returns the ID of the node or leaf that holds the leaves [begin, end).
+    int insert_subtree(const Element *array, int begin, int end) {
+        if (end - begin == 1) {
+            return insert_leaf(array, begin);
+        }
+        int middle = (begin + end) / 2;
+        int left = insert_subtree(array, begin, middle);
+        int right = insert_subtree(array, middle, end);
+        nodes.push_back(Node(left, right));
+        std::pair<int, bool> result = node_ids.insert(nodes.size() - 1);
+        if (!result.second) {
+            nodes.pop_back();
+        }
+        return result.first;
+    }
+
+    void get_subtree(int id, int begin, int end, Element *array) const {
+        if (end - begin == 1) {
+            const Element *leaf = leaves[id];
+            int array_begin = begin * leaf_size;
+            int array_end = std::min(array_begin + leaf_size, array_size);
+            std::copy(leaf, leaf + (array_end - array_begin), array + array_begin);
+            return;
+        }
+        int middle = (begin + end) / 2;
+        get_subtree(nodes[id].first, begin, middle, array);
+        get_subtree(nodes[id].second, middle, end, array);
+    }
+
+    TreeCompressedArraySet(const TreeCompressedArraySet<Element> &) = delete;
+    TreeCompressedArraySet &operator=(const TreeCompressedArraySet<Element> &) = delete;
+public:
+    TreeCompressedArraySet(int array_size, int leaf_size)
+        : array_size((assert(array_size > 0), array_size)),
+          leaf_size((assert(leaf_size > 0), std::min(leaf_size, array_size))),
+          num_leaves((array_size + this->leaf_size - 1) / this->leaf_size),
+          leaves(this->leaf_size),
+          leaf_ids(LeafHash(leaves, this->leaf_size), LeafEqual(leaves, this->leaf_size)),
+          node_ids(NodeHash(nodes), NodeEqual(nodes)),
+          array_ids(RootHash(roots), RootEqual(roots)),
+          leaf_buffer(this->leaf_size, Element()) {
+    }
+
+    /*
+      Adds a copy of the given array unless an equal array was added before.
+      Returns the ID of the array and whether it was added.
+    */
+    std::pair<int, bool> insert(const Element *array) {
+        roots.push_back(insert_subtree(array, 0, num_leaves));
+        std::pair<int, bool> result = array_ids.insert(roots.size() - 1);
+        if (!result.second) {
+            roots.pop_back();
+        }
+        assert(static_cast<int>(roots.size()) == array_ids.size());
+        return result;
+    }
+
+    // Copies the array with the given ID into array.
+    void get(int id, Element *array) const {
+        get_subtree(roots[id], 0, num_leaves, array);
+    }
+
+    size_t size() const {
+        return roots.size();
+    }
+
+    // Estimates the memory used by the stored arrays and hash tables.
+    size_t estimate_memory_in_bytes() const {
+        return leaves.size() * leaf_size * sizeof(Element) +
+               nodes.size() * sizeof(Node) + roots.size() * sizeof(int) +
+               leaf_ids.estimate_memory_in_bytes() +
+               node_ids.estimate_memory_in_bytes() +
+               array_ids.estimate_memory_in_bytes();
+    }
+
+    void print_statistics(utils::LogProxy &log) const {
+        log << "Tree compression leaves: " << leaves.size() << std::endl;
+        log << "Tree compression inner nodes: " << nodes.size() << std::endl;
+        if (roots.size() > 0) {
+            log << "Tree compression bytes per array: "
+                << estimate_memory_in_bytes() / roots.size()
+                << " (uncompressed: " << array_size * sizeof(Element) << ")"
+                << std::endl;
+        }
+    }
+};
+}
+
+#endif
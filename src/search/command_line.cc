@@ -199,6 +199,11 @@ string usage(const string &progname) {
            "    the planning task provided by the policy instead of reading\n"
            "    it from stdin. If used, it must be the first option on the\n"
            "    command line.\n"
+           "--write-binary-task FILENAME\n"
+           "    Writes the task to FILENAME in the binary task format, which\n"
+           "    loads much faster than the translator output. The planner\n"
+           "    reads either format. If used, it must be the first option\n"
+           "    after --remote-policy.\n"
            "--internal-plan-file FILENAME\n"
            "    Plan will be output to a file called FILENAME\n\n"
            "--internal-previous-portfolio-plans COUNTER\n"
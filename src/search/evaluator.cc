@@ -1,5 +1,7 @@
 #include "evaluator.h"
 
+#include "evaluation_context.h"
+
 #include "plugins/plugin.h"
 #include "utils/logging.h"
 #include "utils/system.h"
@@ -74,6 +76,16 @@ int Evaluator::get_cached_estimate(const State &) const {
     ABORT("Called get_cached_estimate when estimate is not cached.");
 }
 
+void Evaluator::compute_successor_values(
+    const State &, const vector<State> &successors, vector<int> &values) {
+    values.clear();
+    values.reserve(successors.size());
+    for (const State &succ : successors) {
+        EvaluationContext context(succ);
+        values.push_back(compute_result(context).get_evaluator_value());
+    }
+}
+
 void add_evaluator_options_to_feature(plugins::Feature &feature) {
     utils::add_log_options_to_feature(feature);
 }
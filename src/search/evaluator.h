@@ -6,6 +6,7 @@
 #include "utils/logging.h"
 
 #include <set>
+#include <vector>
 
 class EvaluationContext;
 class State;
@@ -98,6 +99,17 @@ public:
       the given state is cached, i.e., is_estimate_cached returns true.
     */
     virtual int get_cached_estimate(const State &state) const;
+
+    /*
+      compute_successor_values stores the estimates of the given
+      successors of parent_state in values (EvaluationResult::INFTY for
+      recognized dead ends). The default implementation evaluates
+      every successor in its own evaluation context. Evaluators can
+      override it to share work between the successors of a state.
+    */
+    virtual void compute_successor_values(
+        const State &parent_state, const std::vector<State> &successors,
+        std::vector<int> &values);
 };
 
 extern void add_evaluator_options_to_feature(plugins::Feature &feature);
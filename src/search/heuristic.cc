@@ -95,6 +95,76 @@ EvaluationResult Heuristic::compute_result(EvaluationContext &eval_context) {
     return result;
 }
 
+void Heuristic::compute_heuristics(
+    const vector<State> &ancestor_states, vector<int> &values) {
+    values.clear();
+    values.reserve(ancestor_states.size());
+    for (const State &ancestor_state : ancestor_states) {
+        values.push_back(compute_heuristic(ancestor_state));
+        // preferred operators are not reported for batches
+        preferred_operators.clear();
+    }
+}
+
+void Heuristic::compute_successor_values(
+    const State &, const vector<State> &successors, vector<int> &values) {
+    values.assign(successors.size(), NO_VALUE);
+    /* For each successor, the position of its first occurrence in
+       successors. Different operators often lead to the same successor.
+       The successor lists are short, so a linear scan is cheapest. */
+    vector<int> first_occurrence(successors.size());
+    vector<State> states_to_evaluate;
+    vector<int> positions_to_evaluate;
+    for (size_t i = 0; i < successors.size(); ++i) {
+        const State &succ = successors[i];
+        first_occurrence[i] = i;
+        if (succ.get_registry()) {
+            for (size_t j = 0; j < i; ++j) {
+                if (successors[j].get_registry() == succ.get_registry() &&
+                    successors[j].get_id() == succ.get_id()) {
+                    first_occurrence[i] = j;
+                    break;
+                }
+            }
+        }
+        if (first_occurrence[i] != static_cast<int>(i)) {
+            continue;
+        }
+        if (cache_evaluator_values && heuristic_cache[succ].h != NO_VALUE &&
+            !heuristic_cache[succ].dirty) {
+            values[i] = heuristic_cache[succ].h;
+        } else {
+            states_to_evaluate.push_back(succ);
+            positions_to_evaluate.push_back(i);
+        }
+    }
+
+    if (!states_to_evaluate.empty()) {
+        vector<int> computed_values;
+        compute_heuristics(states_to_evaluate, computed_values);
+        assert(computed_values.size() == states_to_evaluate.size());
+        for (size_t k = 0; k < states_to_evaluate.size(); ++k) {
+            int heuristic = computed_values[k];
+            if (cache_evaluator_values) {
+                heuristic_cache[states_to_evaluate[k]] = HEntry(heuristic, false);
+            }
+            values[positions_to_evaluate[k]] = heuristic;
+        }
+    }
+
+    for (size_t i = 0; i < successors.size(); ++i) {
+        int &heuristic = values[i];
+        if (first_occurrence[i] != static_cast<int>(i)) {
+            heuristic = values[first_occurrence[i]];
+            continue;
+        }
+        assert(heuristic == DEAD_END || heuristic >= 0);
+        if (heuristic == DEAD_END) {
+            heuristic = EvaluationResult::INFTY;
+        }
+    }
+}
+
 bool Heuristic::does_cache_estimates() const {
     return cache_evaluator_values;
 }
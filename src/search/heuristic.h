@@ -61,6 +61,15 @@ protected:
 
     virtual int compute_heuristic(const State &ancestor_state) = 0;
 
+    /*
+      Stores the heuristic values of the given states in values (DEAD_END
+      for dead ends) without computing preferred operators. The default
+      implementation calls compute_heuristic for each state. Heuristics can
+      override it to evaluate several states in one pass.
+    */
+    virtual void compute_heuristics(
+        const std::vector<State> &ancestor_states, std::vector<int> &values);
+
     /*
       Usage note: Marking the same operator as preferred multiple times
       is OK -- it will only appear once in the list of preferred
@@ -68,6 +77,12 @@ protected:
     */
     void set_preferred(const OperatorProxy &op);
 
+    // Discards operators marked as preferred by a computation that is not
+    // an evaluation.
+    void clear_preferred_operators() {
+        preferred_operators.clear();
+    }
+
     State convert_ancestor_state(const State &ancestor_state) const;
 
 public:
@@ -87,6 +102,16 @@ public:
     virtual bool does_cache_estimates() const override;
     virtual bool is_estimate_cached(const State &state) const override;
     virtual int get_cached_estimate(const State &state) const override;
+
+    /*
+      Looks up cached estimates, evaluates identical successors only
+      once and passes the remaining successors to compute_heuristics
+      instead of going through an evaluation context and result per
+      successor.
+    */
+    virtual void compute_successor_values(
+        const State &parent_state, const std::vector<State> &successors,
+        std::vector<int> &values) override;
 };
 
 #endif
@@ -45,14 +45,12 @@ void AdditiveHeuristic::setup_exploration_queue() {
         prop.marked = false;
     }
 
-    // Deal with operators and axioms without preconditions.
-    for (UnaryOperator &op : unary_operators) {
-        op.unsatisfied_preconditions = op.num_preconditions;
-        op.cost = op.base_cost; // will be increased by precondition costs
+    // Operator costs will be increased by precondition costs.
+    counters.reset();
 
-        if (op.unsatisfied_preconditions == 0)
-            enqueue_if_necessary(op.effect, op.base_cost, get_op_id(op));
-    }
+    // Deal with operators and axioms without preconditions.
+    for (OpID op_id : precondition_free_operators)
+        enqueue_if_necessary(effects[op_id], counters.base_costs[op_id], op_id);
 }
 
 void AdditiveHeuristic::setup_exploration_queue_state(const State &state) {
@@ -78,13 +76,13 @@ void AdditiveHeuristic::relaxed_exploration() {
             return;
         for (OpID op_id : precondition_of_pool.get_slice(
                  prop->precondition_of, prop->num_precondition_occurences)) {
-            UnaryOperator *unary_op = get_operator(op_id);
-            increase_cost(unary_op->cost, prop_cost);
-            --unary_op->unsatisfied_preconditions;
-            assert(unary_op->unsatisfied_preconditions >= 0);
-            if (unary_op->unsatisfied_preconditions == 0)
-                enqueue_if_necessary(unary_op->effect,
-                                     unary_op->cost, op_id);
+            int &op_cost = counters.costs[op_id];
+            increase_cost(op_cost, prop_cost);
+            int &unsatisfied = counters.unsatisfied_preconditions[op_id];
+            --unsatisfied;
+            assert(unsatisfied >= 0);
+            if (unsatisfied == 0)
+                enqueue_if_necessary(effects[op_id], op_cost, op_id);
         }
     }
 }
@@ -115,13 +113,16 @@ void AdditiveHeuristic::mark_preferred_operators(
     }
 }
 
-int AdditiveHeuristic::compute_add_and_ff(const State &state) {
+void AdditiveHeuristic::explore(const State &state) {
     setup_exploration_queue();
     setup_exploration_queue_state(state);
     relaxed_exploration();
+}
 
+int AdditiveHeuristic::compute_goal_value(
+    const State &, const vector<PropID> &goals) {
     int total_cost = 0;
-    for (PropID goal_id : goal_propositions) {
+    for (PropID goal_id : goals) {
         const Proposition *goal = get_proposition(goal_id);
         int goal_cost = goal->cost;
         if (goal_cost == -1)
@@ -133,7 +134,8 @@ int AdditiveHeuristic::compute_add_and_ff(const State &state) {
 
 int AdditiveHeuristic::compute_heuristic(const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
-    int h = compute_add_and_ff(state);
+    explore(state);
+    int h = compute_goal_value(state, goal_propositions);
     if (h != DEAD_END) {
         for (PropID goal_id : goal_propositions)
             mark_preferred_operators(state, goal_id);
@@ -60,10 +60,10 @@ class AdditiveHeuristic : public relaxation_heuristic::RelaxationHeuristic {
 
     void write_overflow_warning();
 protected:
+    virtual void explore(const State &state) override;
+    virtual int compute_goal_value(
+        const State &state, const std::vector<PropID> &goals) override;
     virtual int compute_heuristic(const State &ancestor_state) override;
-
-    // Common part of h^add and h^ff computation.
-    int compute_add_and_ff(const State &state);
 public:
     explicit AdditiveHeuristic(const plugins::Options &opts);
 
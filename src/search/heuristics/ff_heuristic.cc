@@ -24,6 +24,7 @@ void FFHeuristic::mark_preferred_operators_and_relaxed_plan(
     Proposition *goal = get_proposition(goal_id);
     if (!goal->marked) { // Only consider each subgoal once.
         goal->marked = true;
+        marked_propositions.push_back(goal_id);
         OpID op_id = goal->reached_by;
         if (op_id != NO_OP) { // We have not yet chained back to a start node.
             UnaryOperator *unary_op = get_operator(op_id);
@@ -49,15 +50,19 @@ void FFHeuristic::mark_preferred_operators_and_relaxed_plan(
     }
 }
 
-int FFHeuristic::compute_heuristic(const State &ancestor_state) {
-    State state = convert_ancestor_state(ancestor_state);
-    int h_add = compute_add_and_ff(state);
+int FFHeuristic::compute_goal_value(
+    const State &state, const vector<PropID> &goals) {
+    int h_add = AdditiveHeuristic::compute_goal_value(state, goals);
     if (h_add == DEAD_END)
         return h_add;
 
     // Collecting the relaxed plan also sets the preferred operators.
-    for (PropID goal_id : goal_propositions)
+    for (PropID goal_id : goals)
         mark_preferred_operators_and_relaxed_plan(state, goal_id);
+    // Clean up for the relaxed plans of other goals of the same exploration.
+    for (PropID prop_id : marked_propositions)
+        get_proposition(prop_id)->marked = false;
+    marked_propositions.clear();
 
     int h_ff = 0;
     for (size_t op_no = 0; op_no < relaxed_plan.size(); ++op_no) {
@@ -69,6 +74,12 @@ int FFHeuristic::compute_heuristic(const State &ancestor_state) {
     return h_ff;
 }
 
+int FFHeuristic::compute_heuristic(const State &ancestor_state) {
+    State state = convert_ancestor_state(ancestor_state);
+    explore(state);
+    return compute_goal_value(state, goal_propositions);
+}
+
 class FFHeuristicFeature : public plugins::TypedFeature<Evaluator, FFHeuristic> {
 public:
     FFHeuristicFeature() : TypedFeature("ff") {
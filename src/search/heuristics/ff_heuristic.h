@@ -27,9 +27,13 @@ class FFHeuristic : public additive_heuristic::AdditiveHeuristic {
     // as a bit vector.
     using RelaxedPlan = std::vector<bool>;
     RelaxedPlan relaxed_plan;
+    // Propositions marked while collecting the relaxed plan.
+    std::vector<PropID> marked_propositions;
     void mark_preferred_operators_and_relaxed_plan(
         const State &state, PropID goal_id);
 protected:
+    virtual int compute_goal_value(
+        const State &state, const std::vector<PropID> &goals) override;
     virtual int compute_heuristic(const State &ancestor_state) override;
 public:
     explicit FFHeuristic(const plugins::Options &opts);
@@ -9,6 +9,7 @@
 #include "../utils/logging.h"
 #include "../utils/memory.h"
 
+#include <algorithm>
 #include <iostream>
 
 using namespace std;
@@ -16,7 +17,12 @@ using namespace std;
 namespace lm_cut_heuristic {
 LandmarkCutHeuristic::LandmarkCutHeuristic(const plugins::Options &opts)
     : Heuristic(opts),
-      landmark_generator(utils::make_unique_ptr<LandmarkCutLandmarks>(task_proxy)) {
+      landmark_generator(utils::make_unique_ptr<LandmarkCutLandmarks>(task_proxy)),
+      incremental(opts.get<bool>("incremental")),
+      transition_registry(nullptr),
+      transition_parent(StateID::no_state),
+      transition_op(OperatorID::no_operator),
+      transition_child(StateID::no_state) {
     if (log.is_at_least_normal()) {
         log << "Initializing landmark cut heuristic..." << endl;
     }
@@ -25,16 +31,77 @@ LandmarkCutHeuristic::LandmarkCutHeuristic(const plugins::Options &opts)
 LandmarkCutHeuristic::~LandmarkCutHeuristic() {
 }
 
+void LandmarkCutHeuristic::get_path_dependent_evaluators(set<Evaluator *> &evals) {
+    if (incremental) {
+        evals.insert(this);
+    }
+}
+
+void LandmarkCutHeuristic::notify_state_transition(
+    const State &parent_state, OperatorID op_id, const State &state) {
+    if (transition_registry == parent_state.get_registry() &&
+        transition_parent != parent_state.get_id() &&
+        transition_parent != StateID::no_state) {
+        /* The search notifies us about all successors of a state before it
+           expands the next state, so we no longer need the landmarks of the
+           previous parent. */
+        vector<int>().swap(
+            stored_landmarks[transition_registry->lookup_state(transition_parent)]);
+    }
+    transition_registry = parent_state.get_registry();
+    transition_parent = parent_state.get_id();
+    transition_op = op_id;
+    transition_child = state.get_id();
+}
+
 int LandmarkCutHeuristic::compute_heuristic(const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
+
+    /*
+      A landmark of the parent that does not contain the operator leading to
+      the state is also a landmark of the state, since prefixing a plan for
+      the state with the operator yields a plan for the parent. Reusing these
+      landmarks with their costs keeps the cost partitioning admissible, and
+      LM-cut only has to find landmarks for the remaining operator costs
+      (Pommerening and Helmert, 2013).
+    */
+    vector<pair<LandmarkCutLandmarks::Landmark, int>> initial_landmarks;
+    if (incremental && transition_registry &&
+        ancestor_state.get_registry() == transition_registry &&
+        ancestor_state.get_id() == transition_child) {
+        const vector<int> &parent_landmarks = stored_landmarks[
+            transition_registry->lookup_state(transition_parent)];
+        for (size_t pos = 0; pos < parent_landmarks.size();) {
+            int cost = parent_landmarks[pos];
+            int size = parent_landmarks[pos + 1];
+            auto begin = parent_landmarks.begin() + pos + 2;
+            auto end = begin + size;
+            if (find(begin, end, transition_op.get_index()) == end) {
+                initial_landmarks.emplace_back(
+                    LandmarkCutLandmarks::Landmark(begin, end), cost);
+            }
+            pos += 2 + size;
+        }
+    }
+
     int total_cost = 0;
+    vector<int> landmarks;
     bool dead_end = landmark_generator->compute_landmarks(
         state,
         [&total_cost](int cut_cost) {total_cost += cut_cost;},
-        nullptr);
+        incremental ?
+        [&landmarks](const LandmarkCutLandmarks::Landmark &landmark, int cost) {
+            landmarks.push_back(cost);
+            landmarks.push_back(landmark.size());
+            landmarks.insert(landmarks.end(), landmark.begin(), landmark.end());
+        } : LandmarkCutLandmarks::LandmarkCallback(),
+        initial_landmarks);
 
     if (dead_end)
         return DEAD_END;
+    if (incremental && ancestor_state.get_registry()) {
+        stored_landmarks[ancestor_state] = move(landmarks);
+    }
     return total_cost;
 }
 
@@ -43,6 +110,15 @@ public:
     LandmarkCutHeuristicFeature() : TypedFeature("lmcut") {
         document_title("Landmark-cut heuristic");
 
+        add_option<bool>(
+            "incremental",
+            "reuse the landmarks of the parent state that do not contain the "
+            "operator leading to the evaluated state, and only compute "
+            "landmarks for the remaining operator costs "
+            "(Pommerening and Helmert, 2013). This requires storing the "
+            "landmarks of all states that have been evaluated, but not "
+            "expanded yet.",
+            "false");
         Heuristic::add_options_to_feature(*this);
 
         document_language_support("action costs", "supported");
@@ -53,6 +129,16 @@ public:
         document_property("consistent", "no");
         document_property("safe", "yes");
         document_property("preferred operators", "no");
+
+        document_note(
+            "Incremental computation",
+            "With incremental=true, the heuristic value of a state depends on "
+            "the path on which it was reached, but remains admissible. The "
+            "landmarks of a state are dropped when the search notifies the "
+            "heuristic about the successors of the next state, so lazy search "
+            "and states reached without a notification fall back to the full "
+            "computation. The operator IDs of the heuristic's task must match "
+            "those of the search task, which holds for adapt_costs().");
     }
 };
 
@@ -2,8 +2,10 @@
 #define HEURISTICS_LM_CUT_HEURISTIC_H
 
 #include "../heuristic.h"
+#include "../per_state_information.h"
 
 #include <memory>
+#include <vector>
 
 namespace plugins {
 class Options;
@@ -15,10 +17,29 @@ class LandmarkCutLandmarks;
 class LandmarkCutHeuristic : public Heuristic {
     std::unique_ptr<LandmarkCutLandmarks> landmark_generator;
 
+    /*
+      In incremental mode, the landmarks of evaluated states are stored
+      until the states are expanded. Each landmark is stored as its cost,
+      its size and its operator IDs.
+    */
+    const bool incremental;
+    PerStateInformation<std::vector<int>> stored_landmarks;
+    // The last transition the search notified us about.
+    const StateRegistry *transition_registry;
+    StateID transition_parent;
+    OperatorID transition_op;
+    StateID transition_child;
+
     virtual int compute_heuristic(const State &ancestor_state) override;
 public:
     explicit LandmarkCutHeuristic(const plugins::Options &opts);
     virtual ~LandmarkCutHeuristic() override;
+
+    virtual void get_path_dependent_evaluators(
+        std::set<Evaluator *> &evals) override;
+    virtual void notify_state_transition(
+        const State &parent_state, OperatorID op_id,
+        const State &state) override;
 };
 }
 
@@ -275,10 +275,27 @@ void LandmarkCutLandmarks::validate_h_max() const {
 
 bool LandmarkCutLandmarks::compute_landmarks(
     const State &state, const CostCallback &cost_callback,
-    const LandmarkCallback &landmark_callback) {
+    const LandmarkCallback &landmark_callback,
+    const vector<pair<Landmark, int>> &initial_landmarks) {
     for (RelaxedOperator &op : relaxed_operators) {
         op.cost = op.base_cost;
     }
+    /* The relaxed operators are built in the order of the operators, so the
+       relaxed operator of an operator has the operator's index. */
+    for (const auto &[initial_landmark, cost] : initial_landmarks) {
+        for (int op_id : initial_landmark) {
+            RelaxedOperator &op = relaxed_operators[op_id];
+            assert(op.original_op_id == op_id);
+            op.cost -= cost;
+            assert(op.cost >= 0);
+        }
+        if (cost_callback) {
+            cost_callback(cost);
+        }
+        if (landmark_callback) {
+            landmark_callback(initial_landmark, cost);
+        }
+    }
     // The following three variables could be declared inside the loop
     // ("second_exploration_queue" even inside second_exploration),
     // but having them here saves reallocations and hence provides a
@@ -8,6 +8,7 @@
 #include <cassert>
 #include <functional>
 #include <memory>
+#include <utility>
 #include <vector>
 
 namespace lm_cut_heuristic {
@@ -101,10 +102,19 @@ public:
       making a copy of the landmark, so cost_callback should be used if only the
       cost of the landmark is needed.
 
+      If initial_landmarks is not empty, it must contain landmarks of the
+      state with costs that are admissible for the state when added up
+      (e.g., the landmarks computed for the state by a previous call). Their
+      costs are subtracted from the operator costs before computing further
+      landmarks, and they are passed to the callbacks like the discovered
+      landmarks.
+
       Returns true iff state is detected as a dead end.
     */
-    bool compute_landmarks(const State &state, const CostCallback &cost_callback,
-                           const LandmarkCallback &landmark_callback);
+    bool compute_landmarks(
+        const State &state, const CostCallback &cost_callback,
+        const LandmarkCallback &landmark_callback,
+        const std::vector<std::pair<Landmark, int>> &initial_landmarks = {});
 };
 
 inline void RelaxedOperator::update_h_max_supporter() {
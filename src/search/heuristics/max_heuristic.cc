@@ -3,6 +3,8 @@
 #include "../plugins/plugin.h"
 #include "../utils/logging.h"
 
+#include <algorithm>
+#include <bit>
 #include <cassert>
 #include <vector>
 
@@ -23,7 +25,11 @@ namespace max_heuristic {
 
 // construction and destruction
 HSPMaxHeuristic::HSPMaxHeuristic(const plugins::Options &opts)
-    : RelaxationHeuristic(opts) {
+    : RelaxationHeuristic(opts),
+      has_unit_costs(all_of(counters.base_costs.begin(),
+                            counters.base_costs.end(),
+                            [](int cost) {return cost == 1;})),
+      is_candidate(unary_operators.size(), false) {
     if (log.is_at_least_normal()) {
         log << "Initializing HSP max heuristic..." << endl;
     }
@@ -36,14 +42,12 @@ void HSPMaxHeuristic::setup_exploration_queue() {
     for (Proposition &prop : propositions)
         prop.cost = -1;
 
-    // Deal with operators and axioms without preconditions.
-    for (UnaryOperator &op : unary_operators) {
-        op.unsatisfied_preconditions = op.num_preconditions;
-        op.cost = op.base_cost; // will be increased by precondition costs
+    // Operator costs will be increased by precondition costs.
+    counters.reset();
 
-        if (op.unsatisfied_preconditions == 0)
-            enqueue_if_necessary(op.effect, op.base_cost);
-    }
+    // Deal with operators and axioms without preconditions.
+    for (OpID op_id : precondition_free_operators)
+        enqueue_if_necessary(effects[op_id], counters.base_costs[op_id]);
 }
 
 void HSPMaxHeuristic::setup_exploration_queue_state(const State &state) {
@@ -69,26 +73,27 @@ void HSPMaxHeuristic::relaxed_exploration() {
             return;
         for (OpID op_id : precondition_of_pool.get_slice(
                  prop->precondition_of, prop->num_precondition_occurences)) {
-            UnaryOperator *unary_op = get_operator(op_id);
-            unary_op->cost = max(unary_op->cost,
-                                 unary_op->base_cost + prop_cost);
-            --unary_op->unsatisfied_preconditions;
-            assert(unary_op->unsatisfied_preconditions >= 0);
-            if (unary_op->unsatisfied_preconditions == 0)
-                enqueue_if_necessary(unary_op->effect, unary_op->cost);
+            int &op_cost = counters.costs[op_id];
+            op_cost = max(op_cost, counters.base_costs[op_id] + prop_cost);
+            int &unsatisfied = counters.unsatisfied_preconditions[op_id];
+            --unsatisfied;
+            assert(unsatisfied >= 0);
+            if (unsatisfied == 0)
+                enqueue_if_necessary(effects[op_id], op_cost);
         }
     }
 }
 
-int HSPMaxHeuristic::compute_heuristic(const State &ancestor_state) {
-    State state = convert_ancestor_state(ancestor_state);
-
+void HSPMaxHeuristic::explore(const State &state) {
     setup_exploration_queue();
     setup_exploration_queue_state(state);
     relaxed_exploration();
+}
 
+int HSPMaxHeuristic::compute_goal_value(
+    const State &, const vector<PropID> &goals) {
     int total_cost = 0;
-    for (PropID goal_id : goal_propositions) {
+    for (PropID goal_id : goals) {
         const Proposition *goal = get_proposition(goal_id);
         int goal_cost = goal->cost;
         if (goal_cost == -1)
@@ -98,6 +103,114 @@ int HSPMaxHeuristic::compute_heuristic(const State &ancestor_state) {
     return total_cost;
 }
 
+int HSPMaxHeuristic::compute_heuristic(const State &ancestor_state) {
+    State state = convert_ancestor_state(ancestor_state);
+    explore(state);
+    return compute_goal_value(state, goal_propositions);
+}
+
+void HSPMaxHeuristic::compute_unit_cost_block(
+    const vector<State> &ancestor_states, int begin, int end,
+    vector<int> &values) {
+    int num_states = end - begin;
+    assert(num_states >= 1 && num_states <= 64);
+    uint64_t all_states = num_states == 64 ?
+        ~uint64_t(0) : (uint64_t(1) << num_states) - 1;
+
+    fill(reached.begin(), reached.end(), 0);
+    changed_propositions.clear();
+    for (int i = 0; i < num_states; ++i) {
+        State state = convert_ancestor_state(ancestor_states[begin + i]);
+        for (FactProxy fact : state) {
+            PropID prop_id = get_prop_id(fact);
+            if (!reached[prop_id])
+                changed_propositions.push_back(prop_id);
+            reached[prop_id] |= uint64_t(1) << i;
+        }
+    }
+
+    uint64_t solved = 0;
+    for (int layer = 0;; ++layer) {
+        uint64_t goals_reached = all_states;
+        for (PropID goal_id : goal_propositions)
+            goals_reached &= reached[goal_id];
+        uint64_t newly_solved = goals_reached & ~solved;
+        while (newly_solved) {
+            int i = countr_zero(newly_solved);
+            values[begin + i] = layer;
+            newly_solved &= newly_solved - 1;
+        }
+        solved |= goals_reached;
+        if (solved == all_states)
+            return;
+
+        /* Only operators with a precondition that changed in the last
+           layer can become applicable for further states. */
+        candidate_operators.clear();
+        if (layer == 0) {
+            for (OpID op_id : precondition_free_operators) {
+                candidate_operators.push_back(op_id);
+                is_candidate[op_id] = true;
+            }
+        }
+        for (PropID prop_id : changed_propositions) {
+            const Proposition &prop = propositions[prop_id];
+            for (OpID op_id : precondition_of_pool.get_slice(
+                     prop.precondition_of, prop.num_precondition_occurences)) {
+                if (!is_candidate[op_id]) {
+                    candidate_operators.push_back(op_id);
+                    is_candidate[op_id] = true;
+                }
+            }
+        }
+
+        next_changed_propositions.clear();
+        for (OpID op_id : candidate_operators) {
+            is_candidate[op_id] = false;
+            uint64_t applicable = all_states;
+            for (PropID pre : get_preconditions(op_id))
+                applicable &= reached[pre];
+            PropID eff = effects[op_id];
+            uint64_t added = applicable & ~reached[eff] & ~newly_reached[eff];
+            if (added) {
+                if (!newly_reached[eff])
+                    next_changed_propositions.push_back(eff);
+                newly_reached[eff] |= added;
+            }
+        }
+        if (next_changed_propositions.empty())
+            break;
+        for (PropID prop_id : next_changed_propositions) {
+            reached[prop_id] |= newly_reached[prop_id];
+            newly_reached[prop_id] = 0;
+        }
+        swap(changed_propositions, next_changed_propositions);
+    }
+
+    uint64_t unsolved = all_states & ~solved;
+    while (unsolved) {
+        int i = countr_zero(unsolved);
+        values[begin + i] = DEAD_END;
+        unsolved &= unsolved - 1;
+    }
+}
+
+void HSPMaxHeuristic::compute_heuristics(
+    const vector<State> &ancestor_states, vector<int> &values) {
+    if (!has_unit_costs || ancestor_states.size() < 2) {
+        Heuristic::compute_heuristics(ancestor_states, values);
+        return;
+    }
+    values.assign(ancestor_states.size(), DEAD_END);
+    reached.resize(propositions.size());
+    newly_reached.resize(propositions.size(), 0);
+    int num_states = ancestor_states.size();
+    for (int begin = 0; begin < num_states; begin += 64) {
+        compute_unit_cost_block(
+            ancestor_states, begin, min(begin + 64, num_states), values);
+    }
+}
+
 class HSPMaxHeuristicFeature : public plugins::TypedFeature<Evaluator, HSPMaxHeuristic> {
 public:
     HSPMaxHeuristicFeature() : TypedFeature("hmax") {
@@ -6,6 +6,8 @@
 #include "../algorithms/priority_queues.h"
 
 #include <cassert>
+#include <cstdint>
+#include <vector>
 
 namespace max_heuristic {
 using relaxation_heuristic::PropID;
@@ -17,9 +19,26 @@ using relaxation_heuristic::UnaryOperator;
 class HSPMaxHeuristic : public relaxation_heuristic::RelaxationHeuristic {
     priority_queues::AdaptiveQueue<PropID> queue;
 
+    /*
+      For tasks with unit costs, h^max is the index of the layer in which
+      the relaxed exploration reaches all goals, so batches of states can be
+      explored together, layer by layer: bit i of reached[prop] is set if
+      prop is reached for the i-th state of a block of up to 64 states.
+    */
+    const bool has_unit_costs;
+    std::vector<uint64_t> reached;
+    std::vector<uint64_t> newly_reached;
+    std::vector<PropID> changed_propositions;
+    std::vector<PropID> next_changed_propositions;
+    std::vector<OpID> candidate_operators;
+    std::vector<bool> is_candidate;
+
     void setup_exploration_queue();
     void setup_exploration_queue_state(const State &state);
     void relaxed_exploration();
+    void compute_unit_cost_block(
+        const std::vector<State> &ancestor_states, int begin, int end,
+        std::vector<int> &values);
 
     void enqueue_if_necessary(PropID prop_id, int cost) {
         assert(cost >= 0);
@@ -31,7 +50,13 @@ class HSPMaxHeuristic : public relaxation_heuristic::RelaxationHeuristic {
         assert(prop->cost != -1 && prop->cost <= cost);
     }
 protected:
+    virtual void explore(const State &state) override;
+    virtual int compute_goal_value(
+        const State &state, const std::vector<PropID> &goals) override;
     virtual int compute_heuristic(const State &ancestor_state) override;
+    virtual void compute_heuristics(
+        const std::vector<State> &ancestor_states,
+        std::vector<int> &values) override;
 public:
     explicit HSPMaxHeuristic(const plugins::Options &opts);
 };
@@ -90,6 +90,22 @@ RelaxationHeuristic::RelaxationHeuristic(const plugins::Options &opts)
             precondition_of_pool.append(precondition_of_vec);
         propositions[prop_id].num_precondition_occurences = precondition_of_vec.size();
     }
+
+    // Build the arrays for the explorations.
+    counters.costs.resize(num_unary_ops);
+    counters.unsatisfied_preconditions.resize(num_unary_ops);
+    counters.base_costs.reserve(num_unary_ops);
+    counters.num_preconditions.reserve(num_unary_ops);
+    effects.reserve(num_unary_ops);
+    for (OpID op_id = 0; op_id < num_unary_ops; ++op_id) {
+        const UnaryOperator &op = unary_operators[op_id];
+        counters.base_costs.push_back(op.base_cost);
+        counters.num_preconditions.push_back(op.num_preconditions);
+        effects.push_back(op.effect);
+        if (op.num_preconditions == 0) {
+            precondition_free_operators.push_back(op_id);
+        }
+    }
 }
 
 bool RelaxationHeuristic::dead_ends_are_reliable() const {
@@ -303,36 +319,54 @@ void RelaxationHeuristic::simplify() {
 }
 
 int RelaxationHeuristic::compute_path_heuristic(const State &start, const State &target) {
-    //build goal propositions for target
-    for (PropID prop_id: goal_propositions) {
+    vector<int> values;
+    compute_path_heuristics(start, {target}, values);
+    return values[0];
+}
+
+void RelaxationHeuristic::compute_path_heuristics(
+    const State &start, const vector<State> &targets, vector<int> &values) {
+    // The exploration has to reach the facts of all targets.
+    for (PropID prop_id : goal_propositions) {
         propositions[prop_id].is_goal = false;
     }
-    goal_propositions.resize(0);
-    goal_propositions.reserve(target.size());
-    for (FactProxy factProxy: target) {
-        PropID prop_id = get_prop_id(factProxy);
-        propositions[prop_id].is_goal = true;
-        goal_propositions.push_back(prop_id);
+    goal_propositions.clear();
+    vector<vector<PropID>> target_propositions;
+    target_propositions.reserve(targets.size());
+    for (const State &target : targets) {
+        vector<PropID> &props = target_propositions.emplace_back();
+        props.reserve(target.size());
+        for (FactProxy fact : target) {
+            PropID prop_id = get_prop_id(fact);
+            props.push_back(prop_id);
+            if (!propositions[prop_id].is_goal) {
+                propositions[prop_id].is_goal = true;
+                goal_propositions.push_back(prop_id);
+            }
+        }
     }
 
-    int h = compute_heuristic(start);
-
-    // reset goal_propositions to make sure that heuristic can be used in expected way after this method has been called
-    // TODO check if this is really necessary
+    State state = convert_ancestor_state(start);
+    explore(state);
+    values.clear();
+    values.reserve(targets.size());
+    for (const vector<PropID> &props : target_propositions) {
+        values.push_back(compute_goal_value(state, props));
+    }
+    // The estimates are not evaluations, so they do not report preferred operators.
+    clear_preferred_operators();
 
-    for (FactProxy factProxy: target) {
-        PropID prop_id = get_prop_id(factProxy);
+    // Restore the goals of the task for the regular evaluations.
+    for (PropID prop_id : goal_propositions) {
         propositions[prop_id].is_goal = false;
     }
     GoalsProxy goals = task_proxy.get_goals();
-    goal_propositions.resize(0);
+    goal_propositions.clear();
     goal_propositions.reserve(goals.size());
-    for (FactProxy goal: goals) {
+    for (FactProxy goal : goals) {
         PropID prop_id = get_prop_id(goal);
         propositions[prop_id].is_goal = true;
         goal_propositions.push_back(prop_id);
     }
-
-    return h;
 }
 }
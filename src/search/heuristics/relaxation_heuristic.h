@@ -7,6 +7,7 @@
 
 #include "../utils/collections.h"
 
+#include <algorithm>
 #include <cassert>
 #include <vector>
 
@@ -37,14 +38,15 @@ struct Proposition {
 
 static_assert(sizeof(Proposition) == 16, "Proposition has wrong size");
 
+/*
+  The static data of a unary operator. The data that changes during an
+  exploration is stored in the arrays of UnaryOperatorCounters.
+*/
 struct UnaryOperator {
     UnaryOperator(int num_preconditions,
                   array_pool::ArrayPoolIndex preconditions,
                   PropID effect,
                   int operator_no, int base_cost);
-    int cost; // Used for h^max cost or h^add cost;
-              // includes operator cost (base_cost)
-    int unsatisfied_preconditions;
     PropID effect;
     int base_cost;
     int num_preconditions;
@@ -52,7 +54,27 @@ struct UnaryOperator {
     int operator_no; // -1 for axioms; index into the task's operators otherwise
 };
 
-static_assert(sizeof(UnaryOperator) == 28, "UnaryOperator has wrong size");
+static_assert(sizeof(UnaryOperator) == 20, "UnaryOperator has wrong size");
+
+/*
+  Per-operator data of an exploration in structure-of-arrays layout. The
+  inner loop of an exploration only touches the costs and the counters of
+  the operators, and reset() initializes both with contiguous copies, which
+  compilers turn into vectorized code.
+*/
+struct UnaryOperatorCounters {
+    // Used for h^max cost or h^add cost; includes operator cost (base_cost).
+    std::vector<int> costs;
+    std::vector<int> unsatisfied_preconditions;
+    std::vector<int> base_costs;
+    std::vector<int> num_preconditions;
+
+    void reset() {
+        std::copy(base_costs.begin(), base_costs.end(), costs.begin());
+        std::copy(num_preconditions.begin(), num_preconditions.end(),
+                  unsatisfied_preconditions.begin());
+    }
+};
 
 class RelaxationHeuristic : public Heuristic {
     void build_unary_operators(const OperatorProxy &op);
@@ -62,6 +84,11 @@ class RelaxationHeuristic : public Heuristic {
     std::vector<PropID> proposition_offsets;
 protected:
     std::vector<UnaryOperator> unary_operators;
+    UnaryOperatorCounters counters;
+    // Effects of the unary operators, indexed like unary_operators.
+    std::vector<PropID> effects;
+    // Unary operators without preconditions.
+    std::vector<OpID> precondition_free_operators;
     std::vector<Proposition> propositions;
     std::vector<PropID> goal_propositions;
 
@@ -109,9 +136,31 @@ protected:
     const Proposition *get_proposition(int var, int value) const;
     Proposition *get_proposition(int var, int value);
     Proposition *get_proposition(const FactProxy &fact);
+
+    /*
+      Runs the relaxed exploration from the given (converted) state until
+      all goal propositions are reached.
+    */
+    virtual void explore(const State &state) = 0;
+    /*
+      Computes the estimate for reaching the given propositions from the
+      state of the last exploration, which must include them among its goal
+      propositions.
+    */
+    virtual int compute_goal_value(
+        const State &state, const std::vector<PropID> &goals) = 0;
 public:
     explicit RelaxationHeuristic(const plugins::Options &options);
     int compute_path_heuristic(const State &start, const State &target);
+    /*
+      Stores the estimates for reaching each of the targets from start in
+      values (DEAD_END for unreachable targets). All targets share one
+      relaxed exploration from start, so this is much cheaper than calling
+      compute_path_heuristic for each target.
+    */
+    void compute_path_heuristics(
+        const State &start, const std::vector<State> &targets,
+        std::vector<int> &values);
     virtual bool dead_ends_are_reliable() const override;
 };
 }
@@ -0,0 +1,171 @@
+#include "bucket_open_list.h"
+
+#include "../evaluator.h"
+#include "../open_list.h"
+
+#include "../algorithms/bucket_queue.h"
+#include "../plugins/plugin.h"
+#include "../utils/memory.h"
+
+#include <cassert>
+#include <vector>
+
+using namespace std;
+
+namespace bucket_open_list {
+template<class Entry>
+class BucketOpenList : public OpenList<Entry> {
+    vector<shared_ptr<Evaluator>> evaluators;
+    /*
+      If allow_unsafe_pruning is true, we ignore (don't insert) states
+      which the first evaluator considers a dead end, even if it is
+      not a safe heuristic.
+    */
+    bool allow_unsafe_pruning;
+
+    bucket_queue::BucketQueue<Entry> buckets;
+    // Reused for computing the keys of inserted entries.
+    vector<int> key;
+
+protected:
+    virtual void do_insertion(EvaluationContext &eval_context,
+                              const Entry &entry) override;
+
+public:
+    explicit BucketOpenList(const plugins::Options &opts);
+    virtual ~BucketOpenList() override = default;
+
+    virtual Entry remove_min() override;
+    virtual bool empty() const override;
+    virtual void clear() override;
+    virtual void get_path_dependent_evaluators(set<Evaluator *> &evals) override;
+    virtual bool is_dead_end(
+        EvaluationContext &eval_context) const override;
+    virtual bool is_reliable_dead_end(
+        EvaluationContext &eval_context) const override;
+};
+
+
+template<class Entry>
+BucketOpenList<Entry>::BucketOpenList(const plugins::Options &opts)
+    : OpenList<Entry>(opts.get<bool>("pref_only")),
+      evaluators(opts.get_list<shared_ptr<Evaluator>>("evals")),
+      allow_unsafe_pruning(opts.get<bool>("unsafe_pruning")),
+      buckets(evaluators.size(), opts.get<int>("max_dense_key")),
+      key(evaluators.size()) {
+}
+
+template<class Entry>
+void BucketOpenList<Entry>::do_insertion(
+    EvaluationContext &eval_context, const Entry &entry) {
+    for (size_t i = 0; i < evaluators.size(); ++i)
+        key[i] = eval_context.get_evaluator_value_or_infinity(evaluators[i].get());
+    buckets.push(key, entry);
+}
+
+template<class Entry>
+Entry BucketOpenList<Entry>::remove_min() {
+    assert(!buckets.empty());
+    return buckets.pop();
+}
+
+template<class Entry>
+bool BucketOpenList<Entry>::empty() const {
+    return buckets.empty();
+}
+
+template<class Entry>
+void BucketOpenList<Entry>::clear() {
+    buckets.clear();
+}
+
+template<class Entry>
+void BucketOpenList<Entry>::get_path_dependent_evaluators(
+    set<Evaluator *> &evals) {
+    for (const shared_ptr<Evaluator> &evaluator : evaluators)
+        evaluator->get_path_dependent_evaluators(evals);
+}
+
+template<class Entry>
+bool BucketOpenList<Entry>::is_dead_end(
+    EvaluationContext &eval_context) const {
+    // Same semantics as in the tie-breaking open list.
+    if (is_reliable_dead_end(eval_context))
+        return true;
+    if (allow_unsafe_pruning &&
+        eval_context.is_evaluator_value_infinite(evaluators[0].get()))
+        return true;
+    for (const shared_ptr<Evaluator> &evaluator : evaluators)
+        if (!eval_context.is_evaluator_value_infinite(evaluator.get()))
+            return false;
+    return true;
+}
+
+template<class Entry>
+bool BucketOpenList<Entry>::is_reliable_dead_end(
+    EvaluationContext &eval_context) const {
+    for (const shared_ptr<Evaluator> &evaluator : evaluators)
+        if (eval_context.is_evaluator_value_infinite(evaluator.get()) &&
+            evaluator->dead_ends_are_reliable())
+            return true;
+    return false;
+}
+
+BucketOpenListFactory::BucketOpenListFactory(const plugins::Options &options)
+    : options(options) {
+}
+
+unique_ptr<StateOpenList>
+BucketOpenListFactory::create_state_open_list() {
+    return utils::make_unique_ptr<BucketOpenList<StateOpenListEntry>>(options);
+}
+
+unique_ptr<EdgeOpenList>
+BucketOpenListFactory::create_edge_open_list() {
+    return utils::make_unique_ptr<BucketOpenList<EdgeOpenListEntry>>(options);
+}
+
+class BucketOpenListFeature : public plugins::TypedFeature<OpenListFactory, BucketOpenListFactory> {
+public:
+    BucketOpenListFeature() : TypedFeature("bucket") {
+        document_title("Bucket open list");
+        document_synopsis(
+            "Open list that orders entries lexicographically by the values of "
+            "the given evaluators with FIFO tie-breaking, like tiebreaking(), "
+            "but stores them in arrays of buckets indexed by the evaluator "
+            "values.");
+
+        add_list_option<shared_ptr<Evaluator>>("evals", "evaluators");
+        add_option<bool>(
+            "pref_only",
+            "insert only nodes generated by preferred operators", "false");
+        add_option<bool>(
+            "unsafe_pruning",
+            "allow unsafe pruning when the main evaluator regards a state a dead end",
+            "true");
+        add_option<int>(
+            "max_dense_key",
+            "evaluator values up to this bound index arrays of buckets. Once a "
+            "larger value occurs for an evaluator among the entries sharing "
+            "the values of the previous evaluators, these entries are "
+            "organized with a hash map and a radix heap instead.",
+            "4096",
+            plugins::Bounds("1", "infinity"));
+
+        document_note(
+            "Implementation Notes",
+            "As long as the evaluator values stay below max_dense_key and the "
+            "smallest values grow monotonically (as f-values in A* with a "
+            "consistent heuristic), inserting and removing an entry takes "
+            "amortized constant time per evaluator. Evaluator values must be "
+            "non-negative.");
+    }
+
+    virtual shared_ptr<BucketOpenListFactory> create_component(const plugins::Options &options, const utils::Context &context) const override {
+        plugins::verify_list_non_empty<shared_ptr<Evaluator>>(context, options, "evals");
+        return make_shared<BucketOpenListFactory>(options);
+    }
+};
+
+static plugins::FeaturePlugin<BucketOpenListFeature> _plugin;
+}
@@ -0,0 +1,27 @@
+#ifndef OPEN_LISTS_BUCKET_OPEN_LIST_H
+#define OPEN_LISTS_BUCKET_OPEN_LIST_H
+
+#include "../open_list_factory.h"
+
+#include "../plugins/plugin.h"
+
+/*
+  Open list with the same semantics as the tie-breaking open list, i.e.,
+  ordered lexicographically by the values of several evaluators with FIFO
+  tie-breaking, but implemented with bucket queues (see
+  algorithms/bucket_queue.h) instead of a map.
+*/
+
+namespace bucket_open_list {
+class BucketOpenListFactory : public OpenListFactory {
+    plugins::Options options;
+public:
+    explicit BucketOpenListFactory(const plugins::Options &options);
+    virtual ~BucketOpenListFactory() override = default;
+
+    virtual std::unique_ptr<StateOpenList> create_state_open_list() override;
+    virtual std::unique_ptr<EdgeOpenList> create_edge_open_list() override;
+};
+}
+
+#endif
@@ -64,7 +64,9 @@ public:
   (similar to the defaultdict class in Python).
 
   The implementation is similar to the one of PerStateInformation, which
-  also contains more documentation.
+  also contains more documentation. Unlike PerStateInformation, PerStateArray
+  (and hence PerStateBitset) does not support concurrent StateRegistries: its
+  entry vectors are not safe to grow while other threads read them.
 */
 
 template<class Element>
@@ -82,6 +84,7 @@ class PerStateArray : public subscriber::Subscriber<StateRegistry> {
             cached_registry = registry;
             auto it = entry_arrays_by_registry.find(registry);
             if (it == entry_arrays_by_registry.end()) {
+                assert(!registry->is_concurrent());
                 cached_entries = new segmented_vector::SegmentedArrayVector<Element>(
                     default_array.size());
                 entry_arrays_by_registry[registry] = cached_entries;
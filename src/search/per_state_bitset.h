@@ -65,6 +65,7 @@ public:
 };
 
 
+// Like PerStateArray, PerStateBitset cannot be used with concurrent StateRegistries.
 class PerStateBitset {
     int num_bits_per_entry;
     PerStateArray<BitsetMath::Block> data;
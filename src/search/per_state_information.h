@@ -3,12 +3,16 @@
 
 #include "state_registry.h"
 
+#include "algorithms/concurrent_segmented_vector.h"
 #include "algorithms/segmented_vector.h"
 #include "algorithms/subscriber.h"
 #include "utils/collections.h"
 
+#include <atomic>
 #include <cassert>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 
 /*
@@ -35,6 +39,13 @@
   stores information. Once a StateRegistry is destroyed, it notifies all
   subscribed objects, which in turn destroy all information stored for states
   in that registry.
+
+  Entries for states of a concurrent StateRegistry are stored separately in
+  ConcurrentSegmentedVectors, which can grow while other threads read them,
+  and are looked up through a thread-safe cache. This way, several threads
+  sharing a concurrent registry can also share a PerStateInformation, while
+  sequential registries keep the cheaper lookup described above. Accesses to
+  the same entry must still be synchronized by the user.
 */
 template<class Entry>
 class PerStateInformation : public subscriber::Subscriber<StateRegistry> {
@@ -46,6 +57,70 @@ class PerStateInformation : public subscriber::Subscriber<StateRegistry> {
     mutable const StateRegistry *cached_registry;
     mutable segmented_vector::SegmentedVector<Entry> *cached_entries;
 
+    using ConcurrentEntryVector = segmented_vector::ConcurrentSegmentedVector<Entry>;
+    struct ConcurrentRegistryEntries {
+        const StateRegistry *registry;
+        ConcurrentEntryVector entries;
+
+        explicit ConcurrentRegistryEntries(const StateRegistry *registry)
+            : registry(registry) {
+        }
+    };
+    using ConcurrentEntryVectorMap = std::unordered_map<
+        const StateRegistry *, std::unique_ptr<ConcurrentRegistryEntries>>;
+    ConcurrentEntryVectorMap concurrent_entries_by_registry;
+    // Protects concurrent_entries_by_registry, which is only used on cache misses.
+    mutable std::mutex concurrent_entries_mutex;
+    /*
+      The registry and its entries are cached together, so a thread cannot see
+      the registry of one cache update and the entries of another.
+    */
+    mutable std::atomic<ConcurrentRegistryEntries *> concurrent_cached;
+
+    ConcurrentRegistryEntries *find_concurrent_entries(
+        const StateRegistry *registry, bool create) const {
+        assert(registry->is_concurrent());
+        ConcurrentRegistryEntries *registry_entries =
+            concurrent_cached.load(std::memory_order_acquire);
+        if (!registry_entries || registry_entries->registry != registry) {
+            std::lock_guard<std::mutex> lock(concurrent_entries_mutex);
+            auto &entries_by_registry = const_cast<ConcurrentEntryVectorMap &>(
+                concurrent_entries_by_registry);
+            auto it = entries_by_registry.find(registry);
+            if (it != entries_by_registry.end()) {
+                registry_entries = it->second.get();
+            } else if (create) {
+                registry_entries = new ConcurrentRegistryEntries(registry);
+                entries_by_registry.emplace(
+                    registry, std::unique_ptr<ConcurrentRegistryEntries>(registry_entries));
+                registry->subscribe(const_cast<PerStateInformation<Entry> *>(this));
+            } else {
+                return nullptr;
+            }
+            concurrent_cached.store(registry_entries, std::memory_order_release);
+        }
+        return registry_entries;
+    }
+
+    Entry &get_concurrent_entry(const StateRegistry *registry, StateID id) {
+        ConcurrentEntryVector &entries = find_concurrent_entries(registry, true)->entries;
+        size_t virtual_size = registry->size();
+        assert(utils::in_bounds(id.value, *registry));
+        if (entries.size() < virtual_size) {
+            entries.grow(virtual_size, default_value);
+        }
+        return entries[id.value];
+    }
+
+    const Entry &read_concurrent_entry(const StateRegistry *registry, StateID id) const {
+        ConcurrentRegistryEntries *registry_entries = find_concurrent_entries(registry, false);
+        if (!registry_entries ||
+            id.value >= static_cast<int>(registry_entries->entries.size())) {
+            return default_value;
+        }
+        return registry_entries->entries[id.value];
+    }
+
     /*
       Returns the SegmentedVector associated with the given StateRegistry.
       If no vector is associated with this registry yet, an empty one is created.
@@ -92,13 +167,15 @@ public:
     PerStateInformation()
         : default_value(),
           cached_registry(nullptr),
-          cached_entries(nullptr) {
+          cached_entries(nullptr),
+          concurrent_cached(nullptr) {
     }
 
     explicit PerStateInformation(const Entry &default_value_)
         : default_value(default_value_),
           cached_registry(nullptr),
-          cached_entries(nullptr) {
+          cached_entries(nullptr),
+          concurrent_cached(nullptr) {
     }
 
     PerStateInformation(const PerStateInformation<Entry> &) = delete;
@@ -117,6 +194,10 @@ public:
                       << "unregistered state." << std::endl;
             utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
         }
+        if (registry->is_concurrent()) {
+            assert(state.get_id() != StateID::no_state);
+            return get_concurrent_entry(registry, state.get_id());
+        }
         segmented_vector::SegmentedVector<Entry> *entries = get_entries(registry);
         int state_id = state.get_id().value;
         assert(state.get_id() != StateID::no_state);
@@ -135,6 +216,10 @@ public:
                       << "unregistered state." << std::endl;
             utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
         }
+        if (registry->is_concurrent()) {
+            assert(state.get_id() != StateID::no_state);
+            return read_concurrent_entry(registry, state.get_id());
+        }
         const segmented_vector::SegmentedVector<Entry> *entries = get_entries(registry);
         if (!entries) {
             return default_value;
@@ -150,6 +235,10 @@ public:
     }
 
     const Entry &read(const StateRegistry &registry, StateID state) const {
+        if (registry.is_concurrent()) {
+            assert(state != StateID::no_state);
+            return read_concurrent_entry(&registry, state);
+        }
         const segmented_vector::SegmentedVector<Entry> *entries = get_entries(&registry);
         if (!entries) {
             return default_value;
@@ -165,6 +254,16 @@ public:
     }
 
     virtual void notify_service_destroyed(const StateRegistry *registry) override {
+        if (registry->is_concurrent()) {
+            std::lock_guard<std::mutex> lock(concurrent_entries_mutex);
+            ConcurrentRegistryEntries *registry_entries =
+                concurrent_cached.load(std::memory_order_relaxed);
+            if (registry_entries && registry_entries->registry == registry) {
+                concurrent_cached.store(nullptr, std::memory_order_relaxed);
+            }
+            concurrent_entries_by_registry.erase(registry);
+            return;
+        }
         delete entries_by_registry[registry];
         entries_by_registry.erase(registry);
         if (registry == cached_registry) {
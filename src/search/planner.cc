@@ -9,9 +9,9 @@
 
 #ifdef POLICY_TESTING_ENABLED
 #include "policy_testing/policies/remote_policy.h"
-#include <sstream>
 #endif /* POLICY_TESTING_ENABLED */
 
+#include <fstream>
 #include <iostream>
 
 using namespace std;
@@ -42,6 +42,16 @@ int main(int argc, const char **argv) {
     }
 #endif /* POLICY_TESTING_ENABLED */
 
+    // if set, write the task in the binary task format to this file after reading it
+    string binary_task_file;
+    if (argc >= 3 && static_cast<string>(argv[1]) == "--write-binary-task") {
+        binary_task_file = static_cast<string>(argv[2]);
+        for (int i = 3; i < argc; ++i) {
+            argv[i - 2] = argv[i];
+        }
+        argc -= 2;
+    }
+
     if (argc < 2) {
         utils::g_log << usage(argv[0]) << endl;
         utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
@@ -55,17 +65,13 @@ int main(int argc, const char **argv) {
             if (input_file_override.empty()) {
                 tasks::read_root_task(cin);
             } else {
-                std::ifstream file_stream(input_file_override);
-                if (!file_stream.is_open()) {
-                    std::cerr << "Cannot open " << input_file_override << std::endl;
-                }
-                tasks::read_root_task(file_stream);
+                tasks::read_root_task_from_file(input_file_override);
             }
         } else {
             try {
+                // The policy server may send the task in either format.
                 std::string task = policy_testing::RemotePolicy::input_fdr();
-                std::istringstream strin(task);
-                tasks::read_root_task(strin);
+                tasks::read_root_task_from_buffer(task);
             } catch (const policy_testing::RemotePolicyError &err) {
                 err.print();
                 utils::exit_with(ExitCode::REMOTE_POLICY_ERROR);
@@ -75,6 +81,15 @@ int main(int argc, const char **argv) {
         tasks::read_root_task(cin);
 #endif /* POLICY_TESTING_ENABLED */
         utils::g_log << "done reading input!" << endl;
+        if (!binary_task_file.empty()) {
+            ofstream binary_task_stream(binary_task_file, ios::binary);
+            tasks::write_binary_root_task(binary_task_stream);
+            if (!binary_task_stream) {
+                cerr << "Could not write binary task to " << binary_task_file << endl;
+                utils::exit_with(ExitCode::SEARCH_CRITICAL_ERROR);
+            }
+            utils::g_log << "wrote binary task to " << binary_task_file << endl;
+        }
         TaskProxy task_proxy(*tasks::g_root_task);
         unit_cost = task_properties::is_unit_cost(task_proxy);
     }
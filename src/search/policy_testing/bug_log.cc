@@ -0,0 +1,190 @@
+#include "bug_log.h"
+
+#include "../abstract_task.h"
+#include "../utils/system.h"
+
+#include <cassert>
+#include <cstring>
+#include <unordered_set>
+
+namespace policy_testing {
+static constexpr char MAGIC[8] = {'P', 'T', 'B', 'U', 'G', 'L', 'O', 'G'};
+static constexpr std::uint32_t VERSION = 1;
+
+template<typename T>
+static void
+append(std::vector<char> &buffer, const T &value) {
+    const char *bytes = reinterpret_cast<const char *>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+template<typename T>
+static bool
+read_value(std::istream &in, T &value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+
+BugLogWriter::BugLogWriter(const std::string &path, int num_variables)
+    : num_variables_(num_variables), out_(path, std::ios::binary) {
+    if (!out_) {
+        std::cerr << "Cannot open bug log " << path << std::endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+    buffer_.reserve(FLUSH_SIZE);
+    buffer_.insert(buffer_.end(), MAGIC, MAGIC + sizeof(MAGIC));
+    append(buffer_, VERSION);
+    append(buffer_, static_cast<std::uint32_t>(num_variables));
+    writer_ = std::thread(&BugLogWriter::run_writer, this);
+}
+
+BugLogWriter::~BugLogWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        hand_over_buffer();
+        done_ = true;
+    }
+    cv_.notify_one();
+    writer_.join();
+}
+
+void
+BugLogWriter::write(const BugLogRecord &record) {
+    assert(static_cast<int>(record.values.size()) == num_variables_);
+    const std::uint32_t payload_size =
+        sizeof(double) + 3 * sizeof(std::int32_t) + 2 * sizeof(std::uint8_t) + num_variables_ * sizeof(std::int32_t);
+    bool flush;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        append(buffer_, payload_size);
+        append(buffer_, record.time);
+        append(buffer_, static_cast<std::int32_t>(record.state_id));
+        append(buffer_, static_cast<std::int32_t>(record.bug_value));
+        append(buffer_, static_cast<std::int32_t>(record.upper_cost_bound));
+        append(buffer_, static_cast<std::uint8_t>(record.source));
+        append(buffer_, static_cast<std::uint8_t>(record.new_bug));
+        for (int value : record.values) {
+            append(buffer_, static_cast<std::int32_t>(value));
+        }
+        flush = buffer_.size() >= FLUSH_SIZE;
+        if (flush) {
+            hand_over_buffer();
+        }
+    }
+    if (flush) {
+        cv_.notify_one();
+    }
+}
+
+void
+BugLogWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    hand_over_buffer();
+    cv_.notify_one();
+    flushed_cv_.wait(lock, [this]() {return pending_.empty() && !writing_;});
+}
+
+void
+BugLogWriter::hand_over_buffer() {
+    if (!buffer_.empty()) {
+        pending_.push_back(std::move(buffer_));
+        buffer_ = std::vector<char>();
+        buffer_.reserve(FLUSH_SIZE);
+    }
+}
+
+void
+BugLogWriter::run_writer() {
+    std::vector<std::vector<char>> buffers;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (!cv_.wait_for(lock, FLUSH_INTERVAL, [this]() {return done_ || !pending_.empty();})) {
+                // timeout: write the records of the partially filled buffer
+                hand_over_buffer();
+            }
+            buffers.swap(pending_);
+            if (buffers.empty()) {
+                if (done_) {
+                    break;
+                }
+                continue;
+            }
+            writing_ = true;
+        }
+        for (const std::vector<char> &buffer : buffers) {
+            out_.write(buffer.data(), buffer.size());
+        }
+        out_.flush();
+        buffers.clear();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            writing_ = false;
+        }
+        flushed_cv_.notify_all();
+    }
+}
+
+std::vector<BugLogRecord>
+read_bug_log(const std::string &path, int num_variables) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(MAGIC)];
+    std::uint32_t version = 0;
+    std::uint32_t logged_num_variables = 0;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0
+        || !read_value(in, version) || version != VERSION || !read_value(in, logged_num_variables)) {
+        std::cerr << path << " is not a bug log" << std::endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+    if (static_cast<int>(logged_num_variables) != num_variables) {
+        std::cerr << "bug log " << path << " does not match the task" << std::endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+    std::vector<BugLogRecord> records;
+    std::uint32_t payload_size;
+    while (read_value(in, payload_size)) {
+        BugLogRecord record;
+        std::int32_t state_id, bug_value, upper_cost_bound;
+        std::uint8_t source, new_bug;
+        if (!read_value(in, record.time) || !read_value(in, state_id) || !read_value(in, bug_value)
+            || !read_value(in, upper_cost_bound) || !read_value(in, source) || !read_value(in, new_bug)) {
+            std::cerr << "bug log " << path << " is truncated" << std::endl;
+            break;
+        }
+        record.state_id = state_id;
+        record.bug_value = bug_value;
+        record.upper_cost_bound = upper_cost_bound;
+        record.source = static_cast<BugLogRecord::Source>(source);
+        record.new_bug = new_bug;
+        record.values.resize(num_variables);
+        bool complete = true;
+        for (int &value : record.values) {
+            std::int32_t v;
+            complete = complete && read_value(in, v);
+            value = v;
+        }
+        if (!complete) {
+            std::cerr << "bug log " << path << " is truncated" << std::endl;
+            break;
+        }
+        records.push_back(std::move(record));
+    }
+    return records;
+}
+
+Pool
+load_bug_log_pool(
+    const std::shared_ptr<AbstractTask> &task,
+    StateRegistry &state_registry,
+    const std::string &path) {
+    Pool result;
+    std::unordered_set<int> seen;
+    for (BugLogRecord &record : read_bug_log(path, task->get_num_variables())) {
+        if (seen.insert(record.state_id).second) {
+            State state = state_registry.insert_state(std::move(record.values));
+            result.emplace_back(-1, StateID::no_state, 0, state);
+        }
+    }
+    std::cout << "... loaded " << result.size() << " bug states" << std::endl;
+    return result;
+}
+} // namespace policy_testing
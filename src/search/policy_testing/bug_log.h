@@ -0,0 +1,96 @@
+#pragma once
+
+#include "bug_value.h"
+#include "pool.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class AbstractTask;
+
+namespace policy_testing {
+/**
+ * A bug report as stored in a bug log.
+ **/
+struct BugLogRecord {
+    enum class Source : std::uint8_t {
+        // result of testing a state with the oracle of the engine
+        TEST = 0,
+        // bug reported by an oracle for another state, e.g., a policy parent
+        ADDITIONAL = 1,
+    };
+
+    // seconds since the start of the planner
+    double time = 0;
+    int state_id = -1;
+    BugValue bug_value = 0;
+    int upper_cost_bound = -1;
+    Source source = Source::TEST;
+    // the state has not been known as a bug before (otherwise its bug value has been improved)
+    bool new_bug = false;
+    std::vector<int> values;
+};
+
+/**
+ * Writes bug reports to a binary bug log. Records are serialized into a buffer that is written to disk by a
+ * background thread, so that logging does not block testing. The thread writes the buffer when it is full and at
+ * least every FLUSH_INTERVAL, so the log is never far behind even if the writer is not destroyed.
+ *
+ * Format (native byte order): the magic "PTBUGLOG", the format version and the number of variables as 32 bit
+ * integers, followed by records. Each record is its 32 bit payload length followed by the payload: the time as
+ * double, the state id, the bug value, and the upper cost bound as 32 bit integers, the source and the new bug
+ * flag as one byte each, and the state values as 32 bit integers.
+ **/
+class BugLogWriter {
+public:
+    BugLogWriter(const std::string &path, int num_variables);
+    ~BugLogWriter();
+
+    void write(const BugLogRecord &record);
+    // Blocks until all records written so far are on disk.
+    void flush();
+
+private:
+    static constexpr std::size_t FLUSH_SIZE = 1 << 16;
+    static constexpr std::chrono::seconds FLUSH_INTERVAL{1};
+
+    const int num_variables_;
+    std::ofstream out_;
+    std::vector<char> buffer_;
+    // buffers handed to the writer thread
+    std::vector<std::vector<char>> pending_;
+    bool done_ = false;
+    // the writer thread is writing buffers taken from pending_
+    bool writing_ = false;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::condition_variable flushed_cv_;
+    std::thread writer_;
+
+    // hands the current buffer to the writer thread; the mutex must be locked
+    void hand_over_buffer();
+    void run_writer();
+};
+
+/**
+ * Reads all records of the bug log at path. Exits if the file is not a bug log for a task with num_variables
+ * variables.
+ **/
+std::vector<BugLogRecord> read_bug_log(const std::string &path, int num_variables);
+
+/**
+ * Returns a pool consisting of the states of the bugs in the bug log (in the order of their first report), e.g.,
+ * to re-test them.
+ **/
+Pool load_bug_log_pool(
+    const std::shared_ptr<AbstractTask> &task,
+    StateRegistry &state_registry,
+    const std::string &path);
+} // namespace policy_testing
@@ -82,6 +82,11 @@ TestingBaseComponent::get_successor_generator() const {
     return env_->get_successor_generator();
 }
 
+FuzzingStateTable *
+TestingBaseComponent::get_fuzzing_state_table() const {
+    return env_->get_fuzzing_state_table();
+}
+
 void
 TestingBaseComponent::generate_applicable_ops(
     const State &state,
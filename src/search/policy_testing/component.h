@@ -45,6 +45,7 @@ public:
     [[nodiscard]] TaskProxy &get_task_proxy() const;
     [[nodiscard]] StateRegistry &get_state_registry() const;
     [[nodiscard]] successor_generator::SuccessorGenerator &get_successor_generator() const;
+    [[nodiscard]] FuzzingStateTable *get_fuzzing_state_table() const;
 
     /** Wrapper function interfacing the state space: **/
 
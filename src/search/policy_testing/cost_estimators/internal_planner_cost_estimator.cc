@@ -4,6 +4,7 @@
 #include "../out_of_resource_exception.h"
 #include "../../heuristics/lm_cut_heuristic.h"
 #include "../../search_algorithms/eager_search.h"
+#include "../../search_algorithms/external_astar_search.h"
 #include "../../search_algorithms/search_common.h"
 #include "../../heuristics/ff_heuristic.h"
 #include "../../search_algorithms/enforced_hill_climbing_search.h"
@@ -20,7 +21,8 @@ InternalPlannerPlanCostEstimator::InternalPlannerPlanCostEstimator(const plugins
       print_output_(opts.get<bool>("print_output")),
       print_plan_(opts.get<bool>("print_plan")),
       max_planner_time(opts.get<int>("max_planner_time")),
-      continue_after_time_out(opts.get<bool>("continue_after_time_out")) {
+      continue_after_time_out(opts.get<bool>("continue_after_time_out")),
+      incremental_lmcut(opts.get<bool>("incremental_lmcut")) {
 }
 
 InternalPlannerPlanCostEstimator::InternalPlannerPlanCostEstimator(TestingEnvironment *env, bool continue_after_timeout)
@@ -29,19 +31,24 @@ InternalPlannerPlanCostEstimator::InternalPlannerPlanCostEstimator(TestingEnviro
       print_output_(false),
       print_plan_(false),
       max_planner_time(14400),
-      continue_after_time_out(continue_after_timeout) {
+      continue_after_time_out(continue_after_timeout),
+      incremental_lmcut(true) {
     connect_environment(env);
 }
 
 void
 InternalPlannerPlanCostEstimator::add_options_to_feature(plugins::Feature &feature) {
-    feature.add_option<Configuration>("conf", "search algorithm, possible choices: astar_lmcut, ehc_ff");
+    feature.add_option<Configuration>("conf", "search algorithm, possible choices: astar_lmcut, ehc_ff, external_astar_lmcut");
     feature.add_option<bool>("print_output", "", "false");
     feature.add_option<bool>("print_plan", "", "false");
     feature.add_option<int>("max_planner_time", "Maximal time to run internal planner.", "14400");
     feature.add_option<bool>("continue_after_time_out",
                              "Continue testing if internal planner oracle ran into a timeout (or runs out of memory).",
                              "true");
+    feature.add_option<bool>("incremental_lmcut",
+                             "Compute LM-cut incrementally along the search paths of astar_lmcut "
+                             "(see the incremental option of lmcut). The plan costs are the same.",
+                             "true");
 }
 
 int
@@ -160,6 +167,7 @@ InternalPlannerPlanCostEstimator::create(double max_time, const State &state, co
         plugins::Options lmcut_opts;
         lmcut_opts.set("transform", g_modified_task);
         lmcut_opts.set("cache_estimates", true);
+        lmcut_opts.set("incremental", incremental_lmcut);
         lmcut_opts.set("verbosity", utils::Verbosity::SILENT);
         std::shared_ptr<Evaluator> lmcut = std::make_shared<lm_cut_heuristic::LandmarkCutHeuristic>(lmcut_opts);
         search_algorithm_opts.set("eval", lmcut);
@@ -194,6 +202,24 @@ InternalPlannerPlanCostEstimator::create(double max_time, const State &state, co
         search_algorithm_opts.set("cost_type", OperatorCost::NORMAL);
         return std::make_shared<enforced_hill_climbing_search::EnforcedHillClimbingSearch>(search_algorithm_opts);
     }
+
+    case Configuration::EXTERNAL_ASTAR_LMCUT:
+    {
+        plugins::Options lmcut_opts;
+        lmcut_opts.set("transform", g_modified_task);
+        lmcut_opts.set("cache_estimates", true);
+        // External search does not notify evaluators about transitions.
+        lmcut_opts.set("incremental", false);
+        lmcut_opts.set("verbosity", utils::Verbosity::SILENT);
+        std::shared_ptr<Evaluator> lmcut = std::make_shared<lm_cut_heuristic::LandmarkCutHeuristic>(lmcut_opts);
+        search_algorithm_opts.set("eval", lmcut);
+        search_algorithm_opts.set("verbosity", utils::Verbosity::SILENT);
+        search_algorithm_opts.set("directory", std::string());
+        search_algorithm_opts.set("max_sorted_records", 1000000);
+        search_algorithm_opts.set("bound", std::numeric_limits<int>::max());
+        search_algorithm_opts.set("cost_type", OperatorCost::NORMAL);
+        return std::make_shared<external_astar_search::ExternalAStarSearch>(search_algorithm_opts);
+    }
     }
     return nullptr;
 }
@@ -211,5 +237,7 @@ static plugins::FeaturePlugin<InternalPlannerPlanCostEstimatorFeature> _plugin;
 static plugins::TypedEnumPlugin<InternalPlannerPlanCostEstimator::Configuration> _enum_plugin({
         {"astar_lmcut", ""},
         {"ehc_ff", ""},
+        {"external_astar_lmcut",
+         "like astar_lmcut, but stores the search space on disk"},
     });
 } // namespace policy_testing
@@ -12,6 +12,7 @@ public:
     enum class Configuration {
         ASTAR_LMCUT,
         EHC_FF,
+        EXTERNAL_ASTAR_LMCUT,
     };
 
     explicit InternalPlannerPlanCostEstimator(const plugins::Options &opts);
@@ -39,6 +40,7 @@ public:
     const bool print_plan_;
     const int max_planner_time;
     const bool continue_after_time_out;
+    const bool incremental_lmcut;
 
 private:
     /** @brief attempt to create a search engine with the given max search time and initial state and
@@ -10,8 +10,10 @@
 #include "../pool_filter.h"
 #include "../state_regions.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <memory>
+#include <numeric>
 #include <vector>
 
 namespace policy_testing {
@@ -31,12 +33,18 @@ PoolFuzzerEngine::PoolFuzzerEngine(const plugins::Options &opts)
       max_walk_length(opts.get<int>("max_walk_length")),
       penalize_policy_fails(opts.get<bool>("penalize_policy_fails")),
       bias_budget(static_cast<unsigned int>(std::max(opts.get<int>("bias_budget"), 0))),
-      cache_bias(opts.get<bool>("cache_bias")) {
+      cache_bias(opts.get<bool>("cache_bias")),
+      lazy_bias(opts.get<bool>("lazy_bias")) {
     fuzzing_time.reset();
     fuzzing_time.stop();
     if (opts.contains("pool_file")) {
         store = std::make_unique<PoolFile>(task, opts.get<std::string>("pool_file"));
     }
+    if (lazy_bias && !bias->has_bias_estimate()) {
+        std::cerr << "warning: the bias does not estimate its values, so lazy_bias computes the bias of every "
+            "successor" << std::endl;
+    }
+    env_.set_fuzzing_state_table(&state_table);
     finish_initialization({bias.get(), filter.get()});
     report_initialized();
     fuzzing_time.resume();
@@ -65,6 +73,12 @@ PoolFuzzerEngine::add_options_to_feature(plugins::Feature &feature) {
     feature.add_option<bool>("cache_bias",
                              "indicates whether the bias should be cached for each state",
                              "false");
+    feature.add_option<bool>("lazy_bias",
+                             "compute the bias only for successors drawn by rejection sampling based on cheap bias "
+                             "estimates; selection probabilities are proportional to the (non-negative) biases. Only "
+                             "detour_bias and loopiness_bias estimate their values, other biases are computed for "
+                             "every successor",
+                             "false");
 
     PolicyTestingBaseEngine::add_options_to_feature(feature, false);
 }
@@ -79,7 +93,7 @@ PoolFuzzerEngine::print_statistics() const {
     utils::HashSet<StateID> pool_bugs;
     utils::HashSet<StateID> qualitative_pool_bugs;
     for (const auto &pool_entry : pool) {
-        StateID pool_state = pool_entry.state.get_id();
+        StateID pool_state = pool_entry.get_state_id();
         auto it = bugs_.find(pool_state);
         if (it != bugs_.end()) {
             pool_bugs.insert(pool_state);
@@ -96,7 +110,7 @@ PoolFuzzerEngine::print_statistics() const {
         } else {
             std::cout << ", ";
         }
-        std::cout << entry.state.get_id();
+        std::cout << entry.get_state_id();
     }
     std::cout << ']' << std::endl;
     std::cout << "Pool bug states: " << pool_bugs.size() << std::endl;
@@ -108,6 +122,10 @@ PoolFuzzerEngine::print_statistics() const {
     std::cout << "Intermediate states added during random walks: " << intermediate_states << std::endl;
     std::cout << "States filtered out: " << filtered << std::endl;
     std::cout << "Failed attempts: " << failed << std::endl;
+    if (lazy_bias) {
+        std::cout << "Lazy bias candidates: " << num_lazy_bias_candidates << std::endl;
+        std::cout << "Lazy bias computations: " << num_lazy_bias_computations << std::endl;
+    }
     novelty_store.print_statistics();
     bias->print_statistics();
     filter->print_statistics();
@@ -127,6 +145,10 @@ PoolFuzzerEngine::step() {
         fuzzing_time.stop();
 
         std::cout << "Computing state regions..." << std::endl;
+        utils::HashSet<StateID> states_in_pool;
+        for (const auto &entry : pool) {
+            states_in_pool.insert(entry.get_state_id());
+        }
         const StateRegions regions = compute_state_regions(task, state_registry, states_in_pool);
         std::cout << "Number of regions: " << regions.size() << std::endl;
 
@@ -164,8 +186,8 @@ PoolFuzzerEngine::insert(int ref, int steps, const State &state) {
         ++filtered;
         return false;
     }
-    states_in_pool.insert(state.get_id());
-    pool.emplace_back(ref, ref < 0 ? StateID::no_state : pool[ref].state.get_id(), steps, state);
+    state_table.set_flag(state, FuzzingStateTable::IN_POOL);
+    pool.emplace_back(ref, ref < 0 ? StateID::no_state : pool[ref].get_state_id(), steps, state);
     novelty_store.insert(state);
     bias->notify_inserted(state);
     print_status_line();
@@ -178,98 +200,219 @@ PoolFuzzerEngine::insert(int ref, int steps, const State &state) {
     return true;
 }
 
-void
-PoolFuzzerEngine::random_walk() {
-    const int ref_index = rng.random(pool.size());
-    const int step_limit = rng.random(max_walk_length) + 1;
-    State state = pool[ref_index].state;
-    int step_counter = 0;
-    for (; step_counter < step_limit; ++step_counter) {
-        std::vector<OperatorID> applicable_ops = successor_generator.generate_applicable_ops(state);
-        rng.shuffle(applicable_ops); // shuffle ops as it could be that not all successors can be considered
-        std::vector<State> successors;
-        std::vector<int> successor_biases;
-        unsigned int used_budget = 0;
+bool
+PoolFuzzerEngine::lookup_cached_bias(const State &succ, int &succ_bias) const {
+    return cache_bias && state_table.lookup_bias(succ, succ_bias);
+}
+
+bool
+PoolFuzzerEngine::is_excluded(const State &succ) {
+    // goal states and states without applicable operators are ignored
+    bool excluded = task_properties::is_goal_state(task_proxy, succ)
+        || !task_properties::exists_applicable_op(task_proxy, succ);
+    if (!excluded) {
+        FuzzingStateTable::Entry &succ_entry = state_table[succ];
+        if (eval && !(succ_entry.flags & FuzzingStateTable::DEAD_END_CHECKED)) {
+            succ_entry.flags |= FuzzingStateTable::DEAD_END_CHECKED;
+            EvaluationContext context(succ);
+            if (eval->compute_result(context).is_infinite()) {
+                succ_entry.flags |= FuzzingStateTable::DEAD_END;
+            }
+        }
+        // states marked by failed walks only count as dead ends if an evaluator is used
+        const bool succ_is_known_dead_end = eval && (succ_entry.flags & FuzzingStateTable::DEAD_END);
+        excluded = succ_is_known_dead_end || bias->can_exclude_state(succ);
+    }
+    if (excluded && cache_bias) {
+        state_table.cache_bias(succ, FuzzingBias::NEGATIVE_INFINITY);
+    }
+    return excluded;
+}
+
+int
+PoolFuzzerEngine::compute_bias(const State &succ, unsigned int &used_budget) {
+    // calculate the remaining budget, 0 indicates no budget set (-> infinity) rather than no budget left
+    assert(!bias_budget || bias_budget > used_budget);
+    const unsigned int remaining_budget = bias_budget ? bias_budget - used_budget : 0;
+    // check policy fail and compute bias
+    const int succ_bias = (penalize_policy_fails && bias->policy_is_known_to_fail(succ, remaining_budget)) ?
+        FuzzingBias::POSITIVE_INFINITY : bias->bias(succ, remaining_budget);
+    used_budget += bias->determine_used_budget(succ, remaining_budget);
+    if (cache_bias) {
+        state_table.cache_bias(succ, succ_bias);
+    }
+    return succ_bias;
+}
+
+const State *
+PoolFuzzerEngine::choose_successor(const State &state, std::vector<State> &successors) {
+    std::vector<OperatorID> applicable_ops = successor_generator.generate_applicable_ops(state);
+    rng.shuffle(applicable_ops); // shuffle ops as it could be that not all successors can be considered
+    std::vector<int> successor_biases;
+    unsigned int used_budget = 0;
+
+    for (OperatorID applicable_op : applicable_ops) {
+        if (check_limits()) {
+            throw OutOfResourceException();
+        }
+        if (is_budget_used_up(used_budget)) {
+            break;
+        }
+        State succ = state_registry.get_successor_state(state, task_proxy.get_operators()[applicable_op]);
+        int succ_bias;
+        if (!lookup_cached_bias(succ, succ_bias)) {
+            succ_bias = is_excluded(succ) ? FuzzingBias::NEGATIVE_INFINITY : compute_bias(succ, used_budget);
+        }
+        if (succ_bias == FuzzingBias::NEGATIVE_INFINITY) {
+            continue;
+        }
+        successors.push_back(succ);
+        successor_biases.push_back(succ_bias);
+    }
+    return FuzzingBias::weighted_choose(rng, successors, successor_biases);
+}
 
-        for (auto &applicable_op : applicable_ops) {
+const State *
+PoolFuzzerEngine::lazy_choose_successor(const State &state, std::vector<State> &successors) {
+    std::vector<OperatorID> applicable_ops = successor_generator.generate_applicable_ops(state);
+    rng.shuffle(applicable_ops);
+    // bias of each candidate, NEGATIVE_INFINITY if not computed yet
+    std::vector<int> successor_biases;
+    std::vector<bool> computed;
+    // upper bound on the selection weight of each candidate
+    std::vector<double> envelope;
+    unsigned int used_budget = 0;
+    // biases are non-negative by contract, the selection weight of a computed bias is the bias itself
+    auto weight = [](int succ_bias) {
+        return succ_bias == FuzzingBias::NEGATIVE_INFINITY ? 0.0 : static_cast<double>(succ_bias);
+    };
+    // set if a bias violates the contract, weighted_choose then shifts all biases by the most negative one
+    bool negative_bias = false;
+    auto compute = [&](size_t i) {
+        successor_biases[i] = compute_bias(successors[i], used_budget);
+        computed[i] = true;
+        ++num_lazy_bias_computations;
+        negative_bias |= successor_biases[i] < 0 && successor_biases[i] != FuzzingBias::NEGATIVE_INFINITY;
+    };
+
+    // stage 1: exclude states, estimate the bias of the remaining ones and compute it if no estimate is known
+    for (OperatorID applicable_op : applicable_ops) {
+        if (check_limits()) {
+            throw OutOfResourceException();
+        }
+        State succ = state_registry.get_successor_state(state, task_proxy.get_operators()[applicable_op]);
+        int succ_bias;
+        bool is_computed = lookup_cached_bias(succ, succ_bias);
+        if (!is_computed && is_excluded(succ)) {
+            continue;
+        }
+        // policy fails are only detected by running the policy, so no estimate bounds a penalized bias
+        const int estimate = is_computed ? succ_bias : (penalize_policy_fails ? FuzzingBias::POSITIVE_INFINITY
+                                                        : bias->estimate_bias(succ, bias_budget));
+        if (estimate == FuzzingBias::NEGATIVE_INFINITY) {
+            continue;
+        }
+        if (!is_computed && estimate == FuzzingBias::POSITIVE_INFINITY && is_budget_used_up(used_budget)) {
+            continue;
+        }
+        ++num_lazy_bias_candidates;
+        successors.push_back(succ);
+        successor_biases.push_back(is_computed ? succ_bias : FuzzingBias::NEGATIVE_INFINITY);
+        computed.push_back(is_computed);
+        envelope.push_back(weight(estimate));
+        if (!is_computed && estimate == FuzzingBias::POSITIVE_INFINITY) {
+            compute(successors.size() - 1);
+            envelope.back() = weight(successor_biases.back());
+        } else if (is_computed) {
+            negative_bias |= succ_bias < 0 && succ_bias != FuzzingBias::NEGATIVE_INFINITY;
+        }
+    }
+    if (std::find(successor_biases.begin(), successor_biases.end(), FuzzingBias::POSITIVE_INFINITY)
+        != successor_biases.end()) {
+        return FuzzingBias::weighted_choose(rng, successors, successor_biases);
+    }
+
+    /*
+      stage 2: rejection sampling with the estimates as envelope. A candidate drawn proportionally to its envelope is
+      accepted with probability weight / envelope, so that it is selected with probability proportional to its
+      weight, and its envelope is tightened to the weight. Biases are only computed for drawn candidates.
+    */
+    while (!negative_bias) {
+        const double total = std::accumulate(envelope.begin(), envelope.end(), 0.0);
+        if (total <= 0) {
+            break;
+        }
+        double sample = rng.random() * total;
+        size_t i = 0;
+        while (i + 1 < envelope.size() && (envelope[i] <= 0 || sample >= envelope[i])) {
+            sample -= envelope[i];
+            ++i;
+        }
+        if (!computed[i]) {
             if (check_limits()) {
                 throw OutOfResourceException();
             }
-            if (bias_budget && used_budget >= bias_budget) {
-                // bias_budget == 0 means no budget set (-> infinity)
+            if (is_budget_used_up(used_budget)) {
                 break;
             }
-            // calculate the remaining budget, 0 indicates no budget set (-> infinity) rather than no budget left
-            assert(!bias_budget || bias_budget > used_budget);
-            const unsigned int remaining_budget = bias_budget ? bias_budget - used_budget : 0;
-            State succ = state_registry.get_successor_state(state, task_proxy.get_operators()[applicable_op]);
-            int succ_bias = 0;
-            bool read_cached_bias = false; // indicates whether a bias value for succ was cached
+            compute(i);
+            if (successor_biases[i] == FuzzingBias::POSITIVE_INFINITY) {
+                // the estimate was no upper bound
+                return &successors[i];
+            }
+            if (negative_bias) {
+                break;
+            }
+        }
+        const double succ_weight = weight(successor_biases[i]);
+        if (rng.random() * envelope[i] < succ_weight) {
+            return &successors[i];
+        }
+        envelope[i] = succ_weight;
+    }
 
-            if (cache_bias) {
-                auto it = bias_cache.find(succ.get_id());
-                if (it != bias_cache.end()) {
-                    // bias is already cached
-                    succ_bias = it->second;
-                    read_cached_bias = true;
-                    if (succ_bias == FuzzingBias::NEGATIVE_INFINITY) {
-                        continue;
-                    }
-                }
+    /*
+      No candidate has a positive weight, the budget is used up or a bias is negative: choose with weighted_choose
+      among the candidates with known bias. A negative bias shifts the weights of all candidates, so their biases are
+      computed as far as the budget allows. Otherwise, a candidate with estimate 0 has bias 0 without computing it.
+    */
+    for (size_t i = 0; i < successors.size(); ++i) {
+        if (computed[i]) {
+            continue;
+        }
+        if (negative_bias) {
+            if (check_limits()) {
+                throw OutOfResourceException();
             }
-            if (!read_cached_bias) { // bias needs to be computed
-                // check if succ is a goal state (in which case, we ignore it)
-                if (task_properties::is_goal_state(task_proxy, succ)) {
-                    if (cache_bias) {
-                        bias_cache.emplace(succ.get_id(), FuzzingBias::NEGATIVE_INFINITY);
-                    }
-                    continue;
-                }
-                // check dead ends
-                bool succ_is_known_dead_end = false;
-                if (!task_properties::exists_applicable_op(task_proxy, succ)) {
-                    if (cache_bias) {
-                        bias_cache.emplace(succ.get_id(), FuzzingBias::NEGATIVE_INFINITY);
-                    }
-                    continue;
-                }
-                if (eval) {
-                    auto insertion = is_dead.emplace(succ.get_id(), false);
-                    auto &inserted_pair = insertion.first;
-                    if (insertion.second) {
-                        EvaluationContext context(succ);
-                        EvaluationResult res = eval->compute_result(context);
-                        inserted_pair->second = res.is_infinite();
-                    }
-                    succ_is_known_dead_end = inserted_pair->second;
-                }
-                if (succ_is_known_dead_end || bias->can_exclude_state(succ)) {
-                    if (cache_bias) {
-                        bias_cache.emplace(succ.get_id(), FuzzingBias::NEGATIVE_INFINITY);
-                    }
-                    continue;
-                }
-                // check policy fail and compute bias
-                succ_bias = (penalize_policy_fails && bias->policy_is_known_to_fail(succ, remaining_budget)) ?
-                    FuzzingBias::POSITIVE_INFINITY : bias->bias(succ, remaining_budget);
-                used_budget += bias->determine_used_budget(succ, remaining_budget);
-                if (cache_bias) {
-                    bias_cache.emplace(succ.get_id(), succ_bias);
-                }
+            if (!is_budget_used_up(used_budget)) {
+                compute(i);
             }
-            successors.push_back(succ);
-            successor_biases.push_back(succ_bias);
+        } else if (envelope[i] <= 0) {
+            successor_biases[i] = 0;
         }
-        const State *selected_state = FuzzingBias::weighted_choose(rng, successors, successor_biases);
+    }
+    return FuzzingBias::weighted_choose(rng, successors, successor_biases);
+}
+
+void
+PoolFuzzerEngine::random_walk() {
+    const int ref_index = rng.random(pool.size());
+    const int step_limit = rng.random(max_walk_length) + 1;
+    State state = pool[ref_index].get_state(state_registry);
+    int step_counter = 0;
+    for (; step_counter < step_limit; ++step_counter) {
+        std::vector<State> successors;
+        const State *selected_state =
+            lazy_bias ? lazy_choose_successor(state, successors) : choose_successor(state, successors);
         if (!selected_state) {
             ++failed;
-            is_dead[state.get_id()] = true;
+            state_table.set_flag(state, FuzzingStateTable::DEAD_END);
             return;
         }
         state = *selected_state;
     }
 
-    if (!states_in_pool.contains(state.get_id())) {
+    if (!state_table.is_in_pool(state)) {
         insert(ref_index, step_counter, state);
     } else {
         ++duplicates;
@@ -2,6 +2,7 @@
 
 #include "../../utils/rng.h"
 #include "../../utils/timer.h"
+#include "../fuzzing_state_table.h"
 #include "../novelty_store.h"
 #include "../pool.h"
 #include "testing_base_engine.h"
@@ -25,13 +26,25 @@ protected:
 private:
     void print_status_line() const;
     void random_walk();
+    [[nodiscard]] bool lookup_cached_bias(const State &succ, int &succ_bias) const;
+    // checks if succ is ignored by the fuzzer (goal state, dead end, or excluded by the bias)
+    bool is_excluded(const State &succ);
+    int compute_bias(const State &succ, unsigned int &used_budget);
+    [[nodiscard]] bool is_budget_used_up(unsigned int used_budget) const {
+        // bias_budget == 0 means no budget set (-> infinity)
+        return bias_budget && used_budget >= bias_budget;
+    }
+    // computes the bias of successors until the budget is used up and chooses one by weighted_choose
+    const State *choose_successor(const State &state, std::vector<State> &successors);
+    // computes the bias only of successors that are drawn by rejection sampling on the bias estimates
+    const State *lazy_choose_successor(const State &state, std::vector<State> &successors);
     bool insert(int ref, int steps, const State &state);
     bool check_limits() const;
 
     Pool pool;
-    utils::HashSet<StateID> states_in_pool;
     NoveltyStore novelty_store;
-    utils::HashMap<StateID, bool> is_dead;  // marks states that are not worthy to be further considered by the parser (not necessarily dead ends)
+    // pool membership, dead-end marks and cached biases of all registered states
+    FuzzingStateTable state_table;
 
     utils::RandomNumberGenerator rng;
 
@@ -47,6 +60,7 @@ private:
     const bool penalize_policy_fails;
     const unsigned int bias_budget;
     const bool cache_bias;
+    const bool lazy_bias;
 
     utils::Timer fuzzing_time;
     unsigned fuzzing_step = 0;
@@ -54,7 +68,7 @@ private:
     unsigned failed = 0;
     unsigned filtered = 0;
     unsigned intermediate_states = 0;
-
-    utils::HashMap<StateID, bool> bias_cache;
+    unsigned long long num_lazy_bias_candidates = 0;
+    unsigned long long num_lazy_bias_computations = 0;
 };
 } // namespace policy_testing
@@ -1,12 +1,28 @@
 #include "pool_policy_tester.h"
 
 #include "../../plugins/plugin.h"
+#include "../bug_log.h"
 #include "../out_of_resource_exception.h"
 
 namespace policy_testing {
+static Pool
+load_test_pool(
+    const plugins::Options &opts,
+    const std::shared_ptr<AbstractTask> &task,
+    StateRegistry &state_registry) {
+    if (opts.contains("pool_file") == opts.contains("retest_bug_log")) {
+        std::cerr << "pool_policy_tester needs either a pool_file or a retest_bug_log." << std::endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+    if (opts.contains("retest_bug_log")) {
+        return load_bug_log_pool(task, state_registry, opts.get<std::string>("retest_bug_log"));
+    }
+    return load_pool_file(task, state_registry, opts.get<std::string>("pool_file"));
+}
+
 PoolPolicyTestingEngine::PoolPolicyTestingEngine(const plugins::Options &opts)
     : PolicyTestingBaseEngine(opts),
-      pool_(load_pool_file(task, state_registry, opts.get<std::string>("pool_file"))),
+      pool_(load_test_pool(opts, task, state_registry)),
       novelty_store_(opts.get<int>("novelty_statistics"), task),
       max_steps_(opts.get<int>("max_steps")),
       first_step_(opts.get<int>("start_from")),
@@ -16,7 +32,7 @@ PoolPolicyTestingEngine::PoolPolicyTestingEngine(const plugins::Options &opts)
     {
         if (!pool_.empty()) {
             State s = state_registry.get_initial_state();
-            State t = pool_[0].state;
+            State t = pool_[0].get_state(state_registry);
             for (unsigned var = 0; var < s.size(); ++var) {
                 if (s[var].get_value() != t[var].get_value()) {
                     std::cerr << "FDR Representation does not match!" << std::endl;
@@ -35,7 +51,7 @@ PoolPolicyTestingEngine::print_statistics() const {
     utils::HashSet<StateID> pool_bugs;
     utils::HashSet<StateID> qualitative_pool_bugs;
     for (const auto &pool_entry : pool_) {
-        StateID pool_state = pool_entry.state.get_id();
+        StateID pool_state = pool_entry.get_state_id();
         auto it = bugs_.find(pool_state);
         if (it != bugs_.end()) {
             pool_bugs.insert(pool_state);
@@ -52,7 +68,7 @@ PoolPolicyTestingEngine::print_statistics() const {
         } else {
             std::cout << ", ";
         }
-        std::cout << entry.state.get_id();
+        std::cout << entry.get_state_id();
     }
     std::cout << ']' << std::endl;
     std::cout << "Pool bug states: " << pool_bugs.size() << std::endl;
@@ -68,7 +84,10 @@ PoolPolicyTestingEngine::print_statistics() const {
 void
 PoolPolicyTestingEngine::add_options_to_feature(plugins::Feature &feature) {
     PolicyTestingBaseEngine::add_options_to_feature(feature, true);
-    feature.add_option<std::string>("pool_file");
+    feature.add_option<std::string>("pool_file", "", plugins::ArgumentInfo::NO_DEFAULT);
+    feature.add_option<std::string>("retest_bug_log",
+                                    "test the bug states recorded in this bug log instead of a pool file",
+                                    plugins::ArgumentInfo::NO_DEFAULT);
     feature.add_option<int>("start_from", "", "0");
     feature.add_option<int>("max_steps", "", "infinity");
     feature.add_option<int>("novelty_statistics", "", "2");
@@ -87,7 +106,7 @@ PoolPolicyTestingEngine::step() {
     const PoolEntry &entry = pool_[step_];
     step_++;
 
-    novelty_store_.insert(entry.state);
+    novelty_store_.insert(entry.get_state(state_registry));
 
     try {
         run_test(entry);
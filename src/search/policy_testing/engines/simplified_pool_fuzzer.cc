@@ -71,7 +71,7 @@ SimplifiedPoolFuzzerEngine::print_statistics() const {
     utils::HashSet<StateID> pool_bugs;
     utils::HashSet<StateID> qualitative_pool_bugs;
     for (const auto &pool_entry : pool_) {
-        StateID pool_state = pool_entry.state.get_id();
+        StateID pool_state = pool_entry.get_state_id();
         auto it = bugs_.find(pool_state);
         if (it != bugs_.end()) {
             pool_bugs.insert(pool_state);
@@ -88,7 +88,7 @@ SimplifiedPoolFuzzerEngine::print_statistics() const {
         } else {
             std::cout << ", ";
         }
-        std::cout << entry.state.get_id();
+        std::cout << entry.get_state_id();
     }
     std::cout << ']' << std::endl;
     std::cout << "Pool bug states: " << pool_bugs.size() << std::endl;
@@ -169,7 +169,7 @@ SimplifiedPoolFuzzerEngine::step() {
 bool
 SimplifiedPoolFuzzerEngine::insert(PoolEntry &&entry) {
     // find out if insertion could take place
-    const State &state = entry.state;
+    const State state = entry.get_state(state_registry);
     if (!filter_->store(state)) {
         ++filtered_;
         return false;
@@ -233,7 +233,7 @@ SimplifiedPoolFuzzerEngine::insert(PoolEntry &&entry) {
     if (novelty_store_)
         novelty_store_->insert(state);
     if (store_) {
-        store_->write(entry);
+        store_->write(entry.ref_index, entry.steps, state);
     }
     print_status_line();
 
@@ -1,5 +1,7 @@
 #include "testing_base_engine.h"
 
+#include "../../evaluation_context.h"
+#include "../../evaluator.h"
 #include "../../plugins/plugin.h"
 #include "../out_of_resource_exception.h"
 #include "../state_regions.h"
@@ -18,7 +20,11 @@ PolicyTestingBaseEngine::PolicyTestingBaseEngine(const plugins::Options &opts)
       write_bugs_file_(opts.contains("bugs_file")),
       read_policy_cache_(opts.get<bool>("read_policy_cache")),
       just_write_policy_cache_(opts.get<bool>("just_write_policy_cache")),
-      debug_(opts.get<bool>("debug")), verbose_(opts.get<bool>("verbose")) {
+      debug_(opts.get<bool>("debug")),
+      certifying_heuristic_(opts.contains("certifying_heuristic") ?
+                            opts.get<std::shared_ptr<Evaluator>>("certifying_heuristic") : nullptr),
+      verbose_(opts.get<bool>("verbose")),
+      print_tests_every_(opts.get<int>("print_tests_every")) {
     testing_timer_.reset();
     testing_timer_.stop();
 
@@ -59,6 +65,9 @@ PolicyTestingBaseEngine::PolicyTestingBaseEngine(const plugins::Options &opts)
     if (write_bugs_file_) {
         bugs_stream_.open(opts.get<std::string>("bugs_file"));
     }
+    if (opts.contains("bug_log")) {
+        bug_log_ = std::make_unique<BugLogWriter>(opts.get<std::string>("bug_log"), task->get_num_variables());
+    }
 }
 
 void
@@ -72,12 +81,27 @@ PolicyTestingBaseEngine::add_options_to_feature(plugins::Feature &feature, bool
     }
     feature.add_option<std::string>("policy_cache_file", "", plugins::ArgumentInfo::NO_DEFAULT);
     feature.add_option<std::string>("bugs_file", "", plugins::ArgumentInfo::NO_DEFAULT);
+    feature.add_option<std::string>(
+        "bug_log",
+        "binary bug log recording state, bug value, upper cost bound and time of every bug report "
+        "(can be re-tested with pool_policy_tester)",
+        plugins::ArgumentInfo::NO_DEFAULT);
     feature.add_option<bool>("read_policy_cache", "", "false");
     feature.add_option<bool>("just_write_policy_cache",
                              "Skip any calls to oracles (and thus the actual testing), just write the policy cache into the provided cache file.",
                              "false");
     feature.add_option<bool>("debug", "", "false");
     feature.add_option<bool>("verbose", "", "false");
+    feature.add_option<int>("print_tests_every",
+                            "print the per-test console output only for every n-th test (0: never); "
+                            "new bugs are always printed",
+                            "1",
+                            plugins::Bounds("0", "infinity"));
+    feature.add_option<std::shared_ptr<Evaluator>>(
+        "certifying_heuristic",
+        "admissible evaluator (w.r.t. the operator costs used by the policy); the oracle is skipped for states on "
+        "which it proves the policy optimal",
+        plugins::ArgumentInfo::NO_DEFAULT);
     SearchAlgorithm::add_options_to_feature(feature);
 }
 
@@ -143,7 +167,7 @@ PolicyTestingBaseEngine::add_additional_bug(const State &state, TestResult test_
     const StateID state_id = state.get_id();
     auto it = bugs_.find(state_id);
     const bool bug_new = it == bugs_.end();
-    const bool tested_before = non_bugs_.contains(state_id);
+    const bool tested_before = non_bugs_.contains(state_id) || certified_.contains(state_id);
 
     if (bug_new) {
         std::cout << "Result for StateID=" << state_id << ": ";
@@ -175,6 +199,7 @@ PolicyTestingBaseEngine::add_additional_bug(const State &state, TestResult test_
     if (bug_new) {
         print_new_bug_info(state, state_id);
     }
+    log_bug(state, test_result, BugLogRecord::Source::ADDITIONAL, bug_new);
     if (write_bugs_file_) {
         bugs_stream_ << std::string(state_id) << "\n" << test_result.to_string() << std::flush;
         if (bug_new && tested_before) {
@@ -193,68 +218,94 @@ TestResult PolicyTestingBaseEngine::get_stored_bug_result(const State &state) {
     }
 }
 
+void
+PolicyTestingBaseEngine::log_bug(
+    const State &state, const TestResult &test_result, BugLogRecord::Source source, bool new_bug) {
+    if (!bug_log_) {
+        return;
+    }
+    BugLogRecord record;
+    record.time = utils::g_timer();
+    record.state_id = state.get_id().get_value();
+    record.bug_value = test_result.bug_value;
+    record.upper_cost_bound = test_result.upper_cost_bound;
+    record.source = source;
+    record.new_bug = new_bug;
+    record.values = state.get_values();
+    bug_log_->write(record);
+}
+
 void
 PolicyTestingBaseEngine::run_test(const PoolEntry &entry, timestamp_t max_time) {
     if (!oracle_ && !just_write_policy_cache_) {
         return;
     }
-    const State &state = entry.state;
+    const State state = entry.get_state(state_registry);
     const StateID state_id = state.get_id();
     testing_timer_.resume();
     set_max_time(max_time);
     ++num_tests_;
-    std::cout << "Starting test " << std::setw(5) << num_tests_ << " [t=" << utils::g_timer << "]" << std::endl;
+    print_test_ = print_tests_every_ && num_tests_ % print_tests_every_ == 0;
+    test_out() << "Starting test " << std::setw(5) << num_tests_ << " [t=" << utils::g_timer << "]" << std::endl;
     if (debug_) {
-        std::cout << "(Debug) StateID=" << state_id << ": " << state << std::endl;
+        test_out() << "(Debug) StateID=" << state_id << ": " << state << std::endl;
     }
     try {
         if (verbose_) {
-            std::cout << "Executing policy on StateID=" << state_id
+            test_out() << "Executing policy on StateID=" << state_id
                       << " [TestNumber=" << num_tests_ << "]..." << std::endl;
         }
         const PolicyCost policy_cost = policy_->compute_policy_cost(state);
-        std::cout << "Policy on StateID=" << state_id << " [TestNumber=" << num_tests_ << "]:  ";
+        test_out() << "Policy on StateID=" << state_id << " [TestNumber=" << num_tests_ << "]:  ";
         if (policy_cost == Policy::UNKNOWN) {
-            std::cout << "aborted [t=" << utils::g_timer << "]" << std::endl;
+            test_out() << "aborted [t=" << utils::g_timer << "]" << std::endl;
         } else if (policy_cost == Policy::UNSOLVED) {
-            std::cout << "not solved [t=" << utils::g_timer << "]" << std::endl;
+            test_out() << "not solved [t=" << utils::g_timer << "]" << std::endl;
         } else {
             assert(policy_cost >= 0);
-            std::cout << "policy_cost=" << policy_cost << " [t=" << utils::g_timer << "]" << std::endl;
+            test_out() << "policy_cost=" << policy_cost << " [t=" << utils::g_timer << "]" << std::endl;
             ++num_solved_;
         }
 
         if (debug_ && policy_cost >= 0) {
             std::vector<OperatorID> plan;
             policy_->execute_get_plan(state, plan, 0);
-            std::cout << "(Debug) plan:\n";
+            test_out() << "(Debug) plan:\n";
             for (auto &i: plan) {
-                std::cout << "(Debug)  " << task_proxy.get_operators()[i].get_name() << "\n";
+                test_out() << "(Debug)  " << task_proxy.get_operators()[i].get_name() << "\n";
             }
-            std::cout << std::flush;
+            test_out() << std::flush;
+        }
+        if (!just_write_policy_cache_ && policy_cost >= 0 && certify_optimality(state, policy_cost)) {
+            ++num_certified_tests_;
+            test_out() << "Result for StateID=" << state_id << " [TestNumber=" << num_tests_ << "]: "
+                      << "policy certified optimal, oracle skipped [t=" << utils::g_timer << "]" << std::endl;
+            test_out() << std::endl;
+            testing_timer_.stop();
+            return;
         }
         bool new_bug_reported = false;
         bool bug_reported = false;
         if (!just_write_policy_cache_) {
             if (verbose_) {
-                std::cout << "Running bug analysis on " << state_id << " [TestNumber=" << num_tests_ << "]..."
+                test_out() << "Running bug analysis on " << state_id << " [TestNumber=" << num_tests_ << "]..."
                           << std::endl;
             }
             TestResult test_result = oracle_->test_driver(*policy_, entry);
-            std::cout << "Result for StateID=" << state_id << " [TestNumber=" << num_tests_ << "]: ";
+            test_out() << "Result for StateID=" << state_id << " [TestNumber=" << num_tests_ << "]: ";
             auto bug_it = bugs_.find(state_id);
             const bool known_bug = bug_it != bugs_.end();
             if (write_bugs_file_ && known_bug) {
                 bugs_stream_ << std::string(state_id) << "\npool" << std::endl;
             }
             if (test_result.bug_value == NOT_APPLICABLE_INDICATOR) {
-                std::cout << "method not applicable";
+                test_out() << "method not applicable";
                 if (!known_bug) {
                     non_bugs_.insert(state_id);
                 }
             } else {
                 if (test_result.bug_value == 0) {
-                    std::cout << "passed";
+                    test_out() << "passed";
                     if (!known_bug) {
                         non_bugs_.insert(state_id);
                     }
@@ -266,25 +317,25 @@ PolicyTestingBaseEngine::run_test(const PoolEntry &entry, timestamp_t max_time)
                             assert(test_result.bug_value != UNSOLVED_BUG_VALUE);
                             assert(policy_cost != Policy::UNSOLVED);
                             if (policy_cost == Policy::UNKNOWN) {
-                                std::cout << "unclassified bug found with value=" << test_result.bug_value;
+                                test_out() << "unclassified bug found with value=" << test_result.bug_value;
                             } else {
-                                std::cout << "quantitative bug found with value=" << test_result.bug_value;
+                                test_out() << "quantitative bug found with value=" << test_result.bug_value;
                             }
                             test_result = best_of(stored_test_result, test_result);
                             stored_test_result = test_result;
                             bug_reported = true;
                         } else {
-                            std::cout << "bug already known, no improved bug value";
+                            test_out() << "bug already known, no improved bug value";
                         }
                     } else {
                         // bug is new
                         if (test_result.bug_value == UNSOLVED_BUG_VALUE) {
                             ++num_unsolved_state_bugs_;
-                            std::cout << "qualitative bug found";
+                            test_out() << "qualitative bug found";
                         } else if (policy_cost == Policy::UNKNOWN) {
-                            std::cout << "unclassified bug found with value=" << test_result.bug_value;
+                            test_out() << "unclassified bug found with value=" << test_result.bug_value;
                         } else {
-                            std::cout << "quantitative bug found with value=" << test_result.bug_value;
+                            test_out() << "quantitative bug found with value=" << test_result.bug_value;
                         }
                         bugs_.emplace(state_id, test_result.bug_value);
                         new_bug_reported = true;
@@ -292,10 +343,13 @@ PolicyTestingBaseEngine::run_test(const PoolEntry &entry, timestamp_t max_time)
                     }
                 }
             }
-            std::cout << " [t=" << utils::g_timer << "]" << std::endl;
+            test_out() << " [t=" << utils::g_timer << "]" << std::endl;
             if (new_bug_reported) {
                 print_new_bug_info(state, state_id);
             }
+            if (bug_reported) {
+                log_bug(state, test_result, BugLogRecord::Source::TEST, new_bug_reported);
+            }
             if (write_bugs_file_) {
                 if (bug_reported) {
                     bugs_stream_ << std::string(state_id) << "\n" << test_result.to_string() << std::flush;
@@ -305,9 +359,9 @@ PolicyTestingBaseEngine::run_test(const PoolEntry &entry, timestamp_t max_time)
                 }
             }
         } else {
-            std::cout << " [t=" << utils::g_timer << "]" << std::endl;
+            test_out() << " [t=" << utils::g_timer << "]" << std::endl;
         }
-        std::cout << std::endl;
+        test_out() << std::endl;
         testing_timer_.stop();
     } catch (const OutOfResourceException &) {
         std::cout.clear();
@@ -318,8 +372,50 @@ PolicyTestingBaseEngine::run_test(const PoolEntry &entry, timestamp_t max_time)
     }
 }
 
+bool
+PolicyTestingBaseEngine::certify_optimality(const State &state, PolicyCost policy_cost) {
+    if (!certifying_heuristic_) {
+        return false;
+    }
+    if (certified_.contains(state.get_id())) {
+        return true;
+    }
+    if (uncertified_.contains(state.get_id())) {
+        return false;
+    }
+    const std::vector<State> path = policy_->read_cached_path(state);
+    if (!policy_->is_goal(path.back())) {
+        return false;
+    }
+    const std::vector<int> action_costs = policy_->read_path_action_costs(path);
+    PolicyCost remaining_cost = policy_cost;
+    for (std::size_t i = 0; i + 1 < path.size(); ++i) {
+        const StateID state_id = path[i].get_id();
+        if (certified_.contains(state_id)) {
+            // the rest of the path has been certified before (without success for the states before it)
+            return false;
+        }
+        if (!uncertified_.contains(state_id)) {
+            EvaluationContext context(path[i]);
+            if (!context.is_evaluator_value_infinite(certifying_heuristic_.get()) &&
+                context.get_evaluator_value(certifying_heuristic_.get()) == remaining_cost) {
+                for (std::size_t j = i; j < path.size(); ++j) {
+                    certified_.insert(path[j].get_id());
+                }
+                return i == 0;
+            }
+            uncertified_.insert(state_id);
+        }
+        remaining_cost -= action_costs[i];
+    }
+    return false;
+}
+
 void
 PolicyTestingBaseEngine::compute_bug_regions_print_result() {
+    if (bug_log_) {
+        bug_log_->flush();
+    }
     if (oracle_ && !just_write_policy_cache_) {
         std::cout << "Computing bug regions..." << std::endl;
 
@@ -330,6 +426,13 @@ PolicyTestingBaseEngine::compute_bug_regions_print_result() {
 
 void
 PolicyTestingBaseEngine::print_bug_statistics() const {
+    // the engine is not destroyed before the planner exits
+    if (bug_log_) {
+        bug_log_->flush();
+    }
+    if (policy_) {
+        policy_->print_statistics();
+    }
     if (oracle_ && !just_write_policy_cache_) {
         std::cout << "Testing time: " << testing_timer_ << std::endl;
         std::cout << "Conducted tests: " << num_tests_ << std::endl;
@@ -337,6 +440,10 @@ PolicyTestingBaseEngine::print_bug_statistics() const {
         std::cout << "Bugs found: " << bugs_.size() << std::endl;
         std::cout << "Unsolved state bugs: " << num_unsolved_state_bugs_ << std::endl;
         std::cout << "States solved by policy: " << num_solved_ << std::endl;
+        if (certifying_heuristic_) {
+            std::cout << "Tests skipped as policy certified optimal: " << num_certified_tests_ << std::endl;
+            std::cout << "States certified optimal: " << certified_.size() << std::endl;
+        }
         oracle_->print_statistics();
     }
 }
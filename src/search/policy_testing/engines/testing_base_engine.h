@@ -3,6 +3,7 @@
 #include "../../search_algorithm.h"
 #include "../../utils/hash.h"
 #include "../../utils/timer.h"
+#include "../bug_log.h"
 #include "../bug_value.h"
 #include "../testing_environment.h"
 #include "../policy.h"
@@ -12,6 +13,8 @@
 #include <memory>
 #include <set>
 
+class Evaluator;
+
 namespace policy_testing {
 class Policy;
 class Oracle;
@@ -82,6 +85,18 @@ protected:
     void compute_bug_regions_print_result();
     void print_bug_statistics() const;
 
+    /**
+     * Writes a bug report to the bug log (if any).
+     */
+    void log_bug(const State &state, const TestResult &test_result, BugLogRecord::Source source, bool new_bug);
+
+    /**
+     * Stream for the per-test console output, discards the output of tests that are not printed.
+     */
+    std::ostream &test_out() {
+        return print_test_ ? std::cout : null_out_;
+    }
+
     TestingEnvironment env_;
 
     utils::HashMap<StateID, TestResult> bugs_;
@@ -92,6 +107,7 @@ protected:
     std::string policy_cache_file_;
     bool write_bugs_file_;
     std::ofstream bugs_stream_;
+    std::unique_ptr<BugLogWriter> bug_log_;
     bool read_policy_cache_;
     bool just_write_policy_cache_;
 
@@ -101,6 +117,28 @@ protected:
 private:
     std::set<TestingBaseComponent *> components_;
 
+    // admissible evaluator used to certify that the policy is optimal on a state before calling the oracle
+    std::shared_ptr<Evaluator> certifying_heuristic_;
+    // states on whose cached policy path the policy is provably optimal
+    utils::HashSet<StateID> certified_;
+    // states where certifying_heuristic_ differs from the cost of the cached policy path
+    utils::HashSet<StateID> uncertified_;
+    unsigned num_certified_tests_ = 0;
+
+    /**
+     * Checks if the policy is provably optimal on state, i.e., if the cached policy path from state has a suffix
+     * starting in s' where the admissible certifying_heuristic_ equals the remaining path cost. All states of such a
+     * suffix are solved optimally (every suffix of an optimal plan is optimal) and are recorded in certified_. States
+     * before the suffix are recorded in uncertified_ and not evaluated again.
+     * @param policy_cost the cost of the policy on state (must be solved)
+     * @return true iff state is certified to be solved optimally
+     */
+    bool certify_optimality(const State &state, PolicyCost policy_cost);
+
     const bool verbose_;
+    // print the per-test console output of every n-th test only (0: never)
+    const int print_tests_every_;
+    bool print_test_ = true;
+    std::ostream null_out_{nullptr};
 };
 } // namespace policy_testing
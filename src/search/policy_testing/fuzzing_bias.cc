@@ -3,6 +3,9 @@
 #include "policies/remote_policy.h"
 #include "../plugins/plugin.h"
 
+#include <algorithm>
+#include <numeric>
+
 namespace policy_testing {
 PolicyBasedBias::PolicyBasedBias(const plugins::Options &opts) :
     policy(opts.contains("policy") ? opts.get<std::shared_ptr<Policy>>("policy"): nullptr),
@@ -32,6 +35,40 @@ bool PolicyBasedBias::policy_is_known_to_fail(const State &s, unsigned int budge
     return policy->compute_lower_policy_cost_bound(s, get_step_limit(budget)).first == Policy::UNSOLVED;
 }
 
+int
+PolicyBasedBias::estimate_path_fragment_value(const State &s, unsigned int budget, bool omit_maximization) {
+    if (min_distance_estimate < 0) {
+        min_distance_estimate = 1;
+        for (OperatorProxy op : get_task_proxy().get_operators()) {
+            if (op.get_cost() <= 0) {
+                min_distance_estimate = 0;
+                break;
+            }
+        }
+    }
+    // the path is cached by the policy, so computing the bias afterwards does not execute the policy again
+    const std::vector<State> path = policy->execute_get_path_fragment(s, get_step_limit(budget), false);
+    if (path.size() < 2) {
+        return NEGATIVE_INFINITY;
+    }
+    const std::vector<int> action_costs = policy->read_path_action_costs(path);
+    auto value = [&](std::size_t i, std::size_t j, int path_fragment_cost) {
+        return path_fragment_cost - (path[i].get_id() != path[j].get_id() ? min_distance_estimate : 0);
+    };
+    if (omit_maximization) {
+        return value(0, path.size() - 1, std::accumulate(action_costs.begin(), action_costs.end(), 0));
+    }
+    int max_value = NEGATIVE_INFINITY;
+    for (std::size_t i = 0; i + 1 < path.size(); ++i) {
+        int path_fragment_cost = 0;
+        for (std::size_t j = i + 1; j < path.size(); ++j) {
+            path_fragment_cost += action_costs[j - 1];
+            max_value = std::max(max_value, value(i, j, path_fragment_cost));
+        }
+    }
+    return max_value;
+}
+
 static class FuzzingBiasPlugin : public plugins::TypedCategoryPlugin<FuzzingBias> {
 public:
     FuzzingBiasPlugin() : TypedCategoryPlugin("FuzzingBias") {
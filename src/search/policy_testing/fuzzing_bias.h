@@ -68,11 +68,11 @@ public:
             }
             // otherwise select index based on weights
             double sample = rng.random() * sum;
-            size_t index = 0;
-            for (size_t i = 0; i < weights.size(); ++i) {
-                sample -= weights[i];
+            size_t index = finite_weight_indices.back();
+            for (size_t i = 0; i < finite_weights.size(); ++i) {
+                sample -= finite_weights[i];
                 if (sample < 0) {
-                    index = i;
+                    index = finite_weight_indices[i];
                     break;
                 }
             }
@@ -93,6 +93,19 @@ public:
      **/
     virtual int bias(const State &, unsigned int /*budget*/) = 0;
 
+    /**
+     * Return a cheap upper bound on bias(s, budget), i.e., one computed without evaluating heuristics or calling a
+     * planner (running the policy is fine, its path is cached for the bias computation), or POSITIVE_INFINITY if no
+     * finite bound is known. NEGATIVE_INFINITY means that bias(s, budget) is NEGATIVE_INFINITY as well. Lets the
+     * fuzzer skip the bias computation for states that are unlikely to be selected anyway.
+     */
+    virtual int estimate_bias(const State &, unsigned int /*budget*/) {return POSITIVE_INFINITY;}
+    /**
+     * Check if estimate_bias returns finite bounds at all. Without them, lazy bias computation computes the bias of
+     * every successor, as the eager computation does.
+     */
+    virtual bool has_bias_estimate() const {return false;}
+
     /**
      * Check if the bias can determine that the given state s should not be considered, e.g., because a safe heuristic s
      * associated with the bias returns \infty for s.
@@ -168,5 +181,18 @@ protected:
         }
         return step_limit;
     }
+
+    /**
+     * Upper bound on biases that subtract a distance estimate between two states s_i, s_j of the policy path from s
+     * from the cost of the path fragment between them, maximized over all such pairs unless omit_maximization is set
+     * (then only the first and last state are considered). The policy is executed, but no estimate is computed:
+     * between different states, the estimate is bounded from below by the minimal action cost if it is positive.
+     * @return NEGATIVE_INFINITY if the policy applies no action
+     */
+    int estimate_path_fragment_value(const State &s, unsigned int budget, bool omit_maximization);
+
+private:
+    // lower bound on the distance estimate between two different states, computed on the first call
+    int min_distance_estimate = -1;
 };
 } // namespace policy_testing
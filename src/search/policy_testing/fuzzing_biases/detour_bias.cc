@@ -66,15 +66,20 @@ DetourBias::bias_with_maximization(const State &state, unsigned int budget) {
     }
     const std::vector<int> action_costs = policy->read_path_action_costs(path);
     int max_value = NEGATIVE_INFINITY;
+    std::vector<int> h_values;
     for (int i = 0; i < path.size() - 1; ++i) {
         const State &s_i = path[i];
+        if (h) {
+            // one relaxed exploration from s_i for all later states of the path
+            h->compute_path_heuristics(s_i, std::vector<State>(path.begin() + i + 1, path.end()), h_values);
+        }
         int path_fragment_cost = 0; // the cost between s_i and s_j
         for (int j = i + 1; j < path.size(); ++j) {
             path_fragment_cost += action_costs[j - 1];
             const State &s_j = path[j];
             int h_value;
             if (h) {
-                h_value = h->compute_path_heuristic(s_i, s_j);
+                h_value = h_values[j - i - 1];
                 if (h_value == Heuristic::DEAD_END || h_value == Heuristic::NO_VALUE) {
                     // this case should never occur for a safe heuristic
                     continue;
@@ -99,6 +104,12 @@ DetourBias::bias(const State &state, unsigned int budget) {
     }
 }
 
+int
+DetourBias::estimate_bias(const State &state, unsigned int budget) {
+    // every detour value is the cost of a path fragment minus a distance estimate
+    return estimate_path_fragment_value(state, budget, omit_maximization);
+}
+
 bool DetourBias::can_exclude_state(const State &) {
     return false;
 }
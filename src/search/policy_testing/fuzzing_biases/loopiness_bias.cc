@@ -87,15 +87,20 @@ LoopinessBias::bias_with_maximization(const State &state, unsigned int budget) {
     }
     const std::vector<int> action_costs = policy->read_path_action_costs(path);
     int max_value = NEGATIVE_INFINITY;
-    for (int i = 0; i < path.size() - 1; ++i) {
-        const State &s_i = path[i];
+    // iterate over the start s_j of the way back first, so all s_i share one relaxed exploration from s_j
+    std::vector<int> h_values;
+    for (int j = 1; j < path.size(); ++j) {
+        const State &s_j = path[j];
+        if (h) {
+            h->compute_path_heuristics(s_j, std::vector<State>(path.begin(), path.begin() + j), h_values);
+        }
         int path_fragment_cost = 0;
-        for (int j = i + 1; j < path.size(); ++j) {
-            path_fragment_cost += action_costs[j - 1];
-            const State &s_j = path[j];
+        for (int i = j - 1; i >= 0; --i) {
+            path_fragment_cost += action_costs[i];
+            const State &s_i = path[i];
             int h_value;
             if (h) {
-                h_value = h->compute_path_heuristic(s_j, s_i);
+                h_value = h_values[i];
                 if (h_value == Heuristic::DEAD_END || h_value == Heuristic::NO_VALUE) {
                     continue;
                 }
@@ -121,6 +126,12 @@ LoopinessBias::bias(const State &state, unsigned int budget) {
     }
 }
 
+int
+LoopinessBias::estimate_bias(const State &state, unsigned int budget) {
+    // every loopiness value is the cost of a path fragment minus a distance estimate
+    return estimate_path_fragment_value(state, budget, omit_maximization);
+}
+
 bool LoopinessBias::can_exclude_state(const State &) {
     return false;
 }
@@ -13,6 +13,8 @@ public:
     int bias_without_maximization(const State &state, unsigned int budget);
     int bias_with_maximization(const State &state, unsigned int budget);
     int bias(const State &state, unsigned int budget) override;
+    int estimate_bias(const State &state, unsigned int budget) override;
+    bool has_bias_estimate() const override {return true;}
     bool can_exclude_state(const State &s) override;
 
 protected:
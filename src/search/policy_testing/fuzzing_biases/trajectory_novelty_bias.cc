@@ -0,0 +1,51 @@
+#include "trajectory_novelty_bias.h"
+
+#include "../../plugins/plugin.h"
+
+namespace policy_testing {
+TrajectoryNoveltyBias::TrajectoryNoveltyBias(const plugins::Options &opts)
+    : PolicyBasedBias(opts),
+      novelty_arity(opts.get<int>("novelty")) {
+}
+
+void
+TrajectoryNoveltyBias::initialize() {
+    if (initialized) {
+        return;
+    }
+    trajectory_novelty = std::make_unique<TrajectoryNovelty>(novelty_arity, get_task());
+    PolicyBasedBias::initialize();
+}
+
+void
+TrajectoryNoveltyBias::add_options_to_feature(plugins::Feature &feature) {
+    feature.add_option<int>("novelty", "maximal size of the fact sets considered", "2",
+                            plugins::Bounds("1", "infinity"));
+    PolicyBasedBias::add_options_to_feature(feature);
+}
+
+int
+TrajectoryNoveltyBias::bias(const State &state, unsigned int budget) {
+    const std::vector<State> path = policy->execute_get_path_fragment(state, get_step_limit(budget), false);
+    return trajectory_novelty->novel_path_prefix_length(path);
+}
+
+void
+TrajectoryNoveltyBias::notify_inserted(const State &state) {
+    // the path has been cached when computing the bias, so the policy is not executed again
+    trajectory_novelty->insert_path(policy->read_cached_path(state));
+}
+
+void
+TrajectoryNoveltyBias::print_statistics() const {
+    trajectory_novelty->print_statistics();
+}
+
+class TrajectoryNoveltyBiasFeature : public plugins::TypedFeature<FuzzingBias, TrajectoryNoveltyBias> {
+public:
+    TrajectoryNoveltyBiasFeature() : TypedFeature("trajectory_novelty_bias") {
+        TrajectoryNoveltyBias::add_options_to_feature(*this);
+    }
+};
+static plugins::FeaturePlugin<TrajectoryNoveltyBiasFeature> _plugin;
+} // namespace policy_testing
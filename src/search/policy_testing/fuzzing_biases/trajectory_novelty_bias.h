@@ -0,0 +1,33 @@
+#pragma once
+
+#include "../fuzzing_bias.h"
+#include "../policy.h"
+#include "../trajectory_novelty.h"
+
+#include <memory>
+
+namespace policy_testing {
+/**
+ * Prefers states whose policy trajectory stays away from the trajectories of the states already in the pool for
+ * many steps. The bias is the number of leading states of the (horizon-limited) policy path without novel fact set.
+ */
+class TrajectoryNoveltyBias : public PolicyBasedBias {
+public:
+    explicit TrajectoryNoveltyBias(const plugins::Options &opts);
+    static void add_options_to_feature(plugins::Feature &feature);
+    int bias(const State &state, unsigned int budget) override;
+    void notify_inserted(const State &state) override;
+    void print_statistics() const override;
+
+    bool can_exclude_state(const State &) override {
+        return false;
+    }
+
+protected:
+    void initialize() override;
+
+private:
+    const int novelty_arity;
+    std::unique_ptr<TrajectoryNovelty> trajectory_novelty;
+};
+} // namespace policy_testing
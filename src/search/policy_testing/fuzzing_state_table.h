@@ -0,0 +1,75 @@
+#pragma once
+
+#include "../per_state_information.h"
+
+#include <cstdint>
+
+namespace policy_testing {
+/**
+ * Dense per-state metadata of a fuzzing run, indexed by the state ids handed out by the state registry. Replaces
+ * separate hash maps for pool membership, dead-end and bias caches by a single 8 byte record per registered state.
+ * Owned by the fuzzing engine and made available to biases and filters through the testing environment.
+ */
+class FuzzingStateTable {
+public:
+    enum Flag : std::uint8_t {
+        IN_POOL = 1 << 0,
+        // the dead-end evaluator has been called on the state, DEAD_END holds its result
+        DEAD_END_CHECKED = 1 << 1,
+        // the state is not worth to be further considered by the fuzzer (not necessarily a dead end)
+        DEAD_END = 1 << 2,
+        // bias holds the (possibly infinite) bias of the state
+        BIAS_CACHED = 1 << 3,
+    };
+
+    struct Entry {
+        int bias = 0;
+        std::uint8_t flags = 0;
+    };
+
+    Entry &operator[](const State &state) {
+        return entries_[state];
+    }
+
+    const Entry &operator[](const State &state) const {
+        return entries_[state];
+    }
+
+    [[nodiscard]] bool has_flag(const State &state, Flag flag) const {
+        return entries_[state].flags & flag;
+    }
+
+    void set_flag(const State &state, Flag flag) {
+        entries_[state].flags |= flag;
+    }
+
+    [[nodiscard]] bool is_in_pool(const State &state) const {
+        return has_flag(state, IN_POOL);
+    }
+
+    [[nodiscard]] bool is_dead_end(const State &state) const {
+        return has_flag(state, DEAD_END);
+    }
+
+    /**
+     * @return true iff a bias has been cached for state, in which case it is written to bias
+     */
+    bool lookup_bias(const State &state, int &bias) const {
+        const Entry &entry = entries_[state];
+        if (entry.flags & BIAS_CACHED) {
+            bias = entry.bias;
+            return true;
+        }
+        return false;
+    }
+
+    void cache_bias(const State &state, int bias) {
+        Entry &entry = entries_[state];
+        entry.bias = bias;
+        entry.flags |= BIAS_CACHED;
+    }
+
+private:
+    PerStateInformation<Entry> entries_;
+};
+} // namespace policy_testing
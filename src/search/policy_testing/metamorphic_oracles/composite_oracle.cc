@@ -99,7 +99,7 @@ CompositeOracle::test(Policy &, const State &) {
 
 TestResult
 CompositeOracle::test_driver(Policy &policy, const PoolEntry &entry) {
-    const State &state = entry.state;
+    const State state = entry.get_state(get_state_registry());
     const PolicyCost upper_policy_cost_bound = policy.compute_upper_policy_cost_bound(state).first;
     if (metamorphic_oracle && metamorphic_oracle->consider_intermediate_states &&
         ((quant_oracle && quant_oracle->consider_intermediate_states) ||
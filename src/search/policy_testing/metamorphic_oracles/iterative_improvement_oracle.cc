@@ -71,7 +71,7 @@ BugValue IterativeImprovementOracle::test_impl(Policy &policy, const State &stat
         }
         // remove it to guarantee that the cost sets remain consistent
         // it is then added later (just like if a new state would be added)
-        removeState(state, upper_cost_bounds[state]);
+        removeState(state.get_id(), upper_cost_bounds[state]);
     }
 
     const auto [lower_policy_cost_bound_new_state,
@@ -95,7 +95,8 @@ BugValue IterativeImprovementOracle::test_impl(Policy &policy, const State &stat
     for (const CostSetRef &set_ref : CostSetIterator(upper_policy_cost_bound_new_state, set_refs)) {
         const auto &cost_set = getCostSet(set_ref);
         const int original_cost_old_state = set_ref.cost;
-        for (const State &old_state : cost_set) {
+        for (StateID old_state_id : cost_set) {
+            const State old_state = get_state_registry().lookup_state(old_state_id);
             ++compared_states;
             if (original_cost_old_state != Policy::UNSOLVED) {
                 // attempt to obtain better policy cost values for both state and old_state via comparisons
@@ -167,7 +168,7 @@ BugValue IterativeImprovementOracle::test_impl(Policy &policy, const State &stat
 
     // remember new state
     upper_cost_bounds[state] = improved_cost_new_state;
-    addState(state, improved_cost_new_state);
+    addState(state.get_id(), improved_cost_new_state);
 
     // make sure upper_cost_bounds are again consistent with state sets and update their parent states
     reorder_state_sets_with_parent_updates(policy);
@@ -206,7 +207,8 @@ IterativeImprovementOracle::test(Policy &, const State &) {
 
 TestResult
 IterativeImprovementOracle::test_driver(Policy &policy, const PoolEntry &entry) {
-    const State &new_state = entry.state;
+    refresh_dominance_relation();
+    const State new_state = entry.get_state(get_state_registry());
     BugValue bug_value = 0;
 
     // execute policy on new_state; needs to be done once -> do not replace with read_lower_policy_cost_bound(new_state)
@@ -273,18 +275,18 @@ IterativeImprovementOracle::test_driver(Policy &policy, const PoolEntry &entry)
 void
 IterativeImprovementOracle::update_cost(const State &s, PolicyCost old_cost, PolicyCost new_cost) {
     const PolicyCost min_cost = Policy::min_cost(upper_cost_bounds[s], new_cost);
-    delayed_cost_set_updates.emplace_back(s, old_cost, min_cost);
+    delayed_cost_set_updates.emplace_back(s.get_id(), old_cost, min_cost);
     upper_cost_bounds[s] = min_cost;
 }
 
-void IterativeImprovementOracle::removeState(const State &state, PolicyCost cost) {
+void IterativeImprovementOracle::removeState(StateID state, PolicyCost cost) {
     assert(cost_set_size);
     --cost_set_size;
     auto &cost_set = getCostSetByCost(cost);
     auto it = std::find(cost_set.begin(), cost_set.end(), state);
     assert(it != cost_set.end());
     if (it == cost_set.end()) {
-        std::cerr << "Trying to remove state with id " << std::string(state.get_id())
+        std::cerr << "Trying to remove state with id " << std::string(state)
                   << " that is not contained in cost set for cost " << cost << std::endl;
         utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
     }
@@ -304,7 +306,7 @@ void IterativeImprovementOracle::reorder_state_sets_with_parent_updates(Policy &
     utils::HashSet<StateID> states_to_update_parents;
     if (update_parents) {
         for (const auto &[state, old_cost, new_cost] : delayed_cost_set_updates) {
-            states_to_update_parents.insert(state.get_id());
+            states_to_update_parents.insert(state);
         }
     }
     reorder_state_sets();
@@ -383,7 +385,8 @@ PolicyCost IterativeImprovementOracle::infer_upper_bound(Policy &policy, const S
         if (original_cost_old_state == Policy::UNSOLVED) {
             continue;
         }
-        for (const State &old_state : cost_set) {
+        for (StateID old_state_id : cost_set) {
+            const State old_state = get_state_registry().lookup_state(old_state_id);
             ++compared_states;
             // attempt to obtain better policy cost values for new_state
             // dominance_old_new = D(old_state, new_state), dominating state is in first position in get_dominance_value
@@ -412,8 +415,8 @@ PolicyCost IterativeImprovementOracle::infer_upper_bound(Policy &policy, const S
     if (old_cost_bound != new_cost_bound) {
         upper_cost_bounds[new_state] = new_cost_bound;
         if (tested_states.contains(new_state.get_id())) {
-            removeState(new_state, old_cost_bound);
-            addState(new_state, new_cost_bound);
+            removeState(new_state.get_id(), old_cost_bound);
+            addState(new_state.get_id(), new_cost_bound);
             const PolicyCost lower_policy_bound_new_state = policy.read_lower_policy_cost_bound(new_state).first;
             if (Policy::is_less(new_cost_bound, lower_policy_bound_new_state)) {
                 const BugValue bug_value =
@@ -451,14 +454,15 @@ void IterativeImprovementOracle::add_external_cost_bound(
 
     if (tested_states.contains(new_state.get_id())) {
         assert(stateIsInCostSet(new_state, old_cost_bound));
-        removeState(new_state, old_cost_bound);
+        removeState(new_state.get_id(), old_cost_bound);
     }
 
     unsigned int compared_states = 0;
     for (const CostSetRef &set_ref : CostSetIterator(old_cost_bound, set_refs)) {
         const auto &cost_set = getCostSet(set_ref);
         const int original_cost_old_state = set_ref.cost;
-        for (const State &old_state : cost_set) {
+        for (StateID old_state_id : cost_set) {
+            const State old_state = get_state_registry().lookup_state(old_state_id);
             ++compared_states;
             assert(new_cost_bound != Policy::UNSOLVED);
 
@@ -507,7 +511,7 @@ void IterativeImprovementOracle::add_external_cost_bound(
 
  comparisons_finished:
     upper_cost_bounds[new_state] = new_cost_bound;
-    addState(new_state, new_cost_bound);
+    addState(new_state.get_id(), new_cost_bound);
     reorder_state_sets_with_parent_updates(policy);
 
     if (update_parents) {
@@ -604,8 +608,8 @@ PolicyCost IterativeImprovementOracle::lookahead_search(Policy &policy, const St
     if (bound_before_update != upper_bound_for_start) {
         cost_bound = upper_bound_for_start;
         if (tested_states.contains(s.get_id())) {
-            removeState(s, bound_before_update);
-            addState(s, upper_bound_for_start);
+            removeState(s.get_id(), bound_before_update);
+            addState(s.get_id(), upper_bound_for_start);
         }
         if (update_parents) {
             update_parent_cost(policy, s);
@@ -52,7 +52,8 @@ struct CostSetRef {
 class IterativeImprovementOracle : public NumericDominanceOracle {
     friend class CompositeOracle;
     friend class CostSetIterator;
-    using StateSet = std::vector<State>;
+    // states are stored by id and only looked up (packed) when compared
+    using StateSet = std::vector<StateID>;
 
     // sets of states with same cost (contains only states from the pool)
     std::deque<StateSet> state_sets;
@@ -63,7 +64,7 @@ class IterativeImprovementOracle : public NumericDominanceOracle {
 
     // delayed states updates
     // tuples contain states, old cost value and new cost value
-    std::vector<std::tuple<State, PolicyCost, PolicyCost>> delayed_cost_set_updates;
+    std::vector<std::tuple<StateID, PolicyCost, PolicyCost>> delayed_cost_set_updates;
 
     // upper bound on the cost of states
     PerStateInformation<PolicyCost> upper_cost_bounds;
@@ -127,7 +128,7 @@ private:
             return false;
         }
         auto &cost_set = getCostSetByCost(cost);
-        auto it = std::find(cost_set.begin(), cost_set.end(), state);
+        auto it = std::find(cost_set.begin(), cost_set.end(), state.get_id());
         return it != cost_set.end();
     }
 
@@ -151,7 +152,7 @@ private:
     /**
      * Adds a given @param state to the state set with cost @param cost. Constructs the state set if necessary.
      */
-    void addState(const State &state, PolicyCost cost) {
+    void addState(StateID state, PolicyCost cost) {
         ++cost_set_size;
         auto it = std::lower_bound(set_refs.cbegin(), set_refs.cend(), CostSetRef(cost));
         if (it != set_refs.end() && it->cost == cost) {
@@ -167,7 +168,7 @@ private:
      * Adds states to respective cost sets.
      * @param states vector of pairs of states and cost values.
      */
-    void addStates(const std::vector<std::pair<State, PolicyCost>> &add_list) {
+    void addStates(const std::vector<std::pair<StateID, PolicyCost>> &add_list) {
         for (const auto &[s, c] : add_list) {
             addState(s, c);
         }
@@ -177,14 +178,14 @@ private:
      * @brief Remove states from respective cost set.
      * @warning the state must exists in the corresponding sets.
      */
-    void removeState(const State &state, PolicyCost cost);
+    void removeState(StateID state, PolicyCost cost);
 
     /**
      * Removes states from respective cost sets.
      * @param states vector of pairs of states and cost values.
      *  @warning the states must exists in the corresponding sets.
      */
-    void removeStates(const std::vector<std::pair<State, PolicyCost>> &remove_list) {
+    void removeStates(const std::vector<std::pair<StateID, PolicyCost>> &remove_list) {
         for (const auto &[s, c] : remove_list) {
             removeState(s, c);
         }
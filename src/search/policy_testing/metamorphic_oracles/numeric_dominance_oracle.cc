@@ -24,6 +24,10 @@ NumericDominanceOracle::NumericDominanceOracle(const plugins::Options &opts)
       sim_file(opts.contains("sim_file") ? opts.get<std::string>("sim_file") : ""),
       write_sim_and_exit(opts.get<bool>("write_sim_and_exit")),
       test_serialization(opts.get<bool>("test_serialization")),
+      anytime(opts.get<bool>("anytime")),
+      coarse_abstraction_builder(opts.get<std::shared_ptr<simulations::AbstractionBuilder>>("anytime_abs")),
+      refined_tau_labels(anytime ? std::make_shared<simulations::TauLabelManager<int>>(opts, false) : nullptr),
+      cache_abstract_state_ids(opts.get<bool>("cache_abstract_state_ids")),
       local_bug_test_kind(opts.get<LocalBugTest>("local_bug_test")),
       read_simulation(opts.get<bool>("read_simulation")) {
     if ((write_sim_and_exit || read_simulation || test_serialization) && sim_file.empty()) {
@@ -36,6 +40,72 @@ NumericDominanceOracle::NumericDominanceOracle(const plugins::Options &opts)
         std::cerr << "You need to specify an abstraction builder if no simulation is to be read." << std::endl;
         std::exit(1);
     }
+    if (anytime && (write_sim_and_exit || read_simulation || test_serialization)) {
+        std::cerr << "The anytime mode cannot be combined with reading or writing simulation files." << std::endl;
+        std::exit(1);
+    }
+}
+
+NumericDominanceOracle::~NumericDominanceOracle() {
+    if (refinement_thread.joinable()) {
+        cancel_refinement.store(true, std::memory_order_relaxed);
+        refinement_thread.join();
+    }
+}
+
+std::unique_ptr<simulations::NumericDominanceRelation<int>>
+NumericDominanceOracle::compute_dominance_relation(
+    const simulations::AbstractionBuilder &builder,
+    const std::shared_ptr<simulations::TauLabelManager<int>> &tau_label_mgr,
+    std::unique_ptr<simulations::LDSimulation> &ld_sim,
+    std::vector<std::unique_ptr<simulations::Abstraction>> &abs_storage) const {
+    ld_sim = builder.build_abstraction(OperatorCost::NORMAL, abs_storage);
+    return ld_sim->compute_numeric_dominance_relation<int>(truncate_value, max_simulation_time, min_simulation_time,
+                                                           max_total_time, max_lts_size_to_compute_simulation,
+                                                           num_labels_to_use_dominates_in,
+                                                           dump, tau_label_mgr);
+}
+
+void NumericDominanceOracle::refine_dominance_relation(std::vector<bool> dead_operators) {
+    utils::Timer refinement_timer;
+    simulations::set_dead_operators(std::move(dead_operators));
+    simulations::set_cancellation_flag(&cancel_refinement);
+    std::unique_ptr<simulations::LDSimulation> new_ldSim;
+    std::vector<std::unique_ptr<simulations::Abstraction>> new_abstractions;
+    std::unique_ptr<simulations::NumericDominanceRelation<int>> new_relation;
+    try {
+        new_relation = compute_dominance_relation(*abstraction_builder, refined_tau_labels, new_ldSim,
+                                                  new_abstractions);
+    } catch (const simulations::ComputationCancelled &) {
+        return;
+    }
+    std::cout << "Computed refined numeric dominance function in " << refinement_timer() << "s" << std::endl;
+    {
+        std::lock_guard<std::mutex> lock(refinement_mutex);
+        refined_ldSim = std::move(new_ldSim);
+        refined_abstractions = std::move(new_abstractions);
+        refined_numeric_dominance_relation = std::move(new_relation);
+    }
+    refined_relation_available.store(true, std::memory_order_release);
+}
+
+void NumericDominanceOracle::refresh_dominance_relation() {
+    if (!refined_relation_available.load(std::memory_order_acquire)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(refinement_mutex);
+        refined_relation_available.store(false, std::memory_order_relaxed);
+        // replace relation before the abstractions it refers to
+        numeric_dominance_relation = std::move(refined_numeric_dominance_relation);
+        ldSim = std::move(refined_ldSim);
+        abstractions = std::move(refined_abstractions);
+        minimal_finite_dominance_value = numeric_dominance_relation->get_minimal_finite_dominance_value();
+        ++dominance_relation_version;
+    }
+    reset_abstract_state_ids();
+    refinement_thread.join();
+    std::cout << "Switched to refined numeric dominance function." << std::endl;
 }
 
 void
@@ -48,14 +118,20 @@ NumericDominanceOracle::initialize() {
     if (write_sim_and_exit || test_serialization || !read_simulation) {
         // simulation needs to be computed
         utils::Timer num_dom_timer;
-        ldSim = abstraction_builder->build_abstraction(OperatorCost::NORMAL, abstractions);
-        numeric_dominance_relation = ldSim->
-            compute_numeric_dominance_relation<int>(truncate_value, max_simulation_time, min_simulation_time,
-                                                    max_total_time, max_lts_size_to_compute_simulation,
-                                                    num_labels_to_use_dominates_in,
-                                                    dump, tau_labels);
+        // refining is pointless if the coarse relation is already the requested one
+        const bool refine_in_background = anytime && !could_be_based_on_atomic_abstraction();
+        numeric_dominance_relation = compute_dominance_relation(
+            refine_in_background ? *coarse_abstraction_builder : *abstraction_builder, tau_labels, ldSim,
+            abstractions);
         num_dom_computation_time = num_dom_timer();
-        std::cout << "Computed numeric dominance function in " << num_dom_computation_time << "s" << std::endl;
+        if (refine_in_background) {
+            std::cout << "Computed coarse numeric dominance function in " << num_dom_computation_time << "s" <<
+                std::endl;
+            refinement_thread = std::thread(&NumericDominanceOracle::refine_dominance_relation, this,
+                                            simulations::SimulationsManager::is_dead_operator);
+        } else {
+            std::cout << "Computed numeric dominance function in " << num_dom_computation_time << "s" << std::endl;
+        }
         minimal_finite_dominance_value = numeric_dominance_relation->get_minimal_finite_dominance_value();
     }
     if (write_sim_and_exit) {
@@ -138,9 +214,34 @@ NumericDominanceOracle::initialize() {
             utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
         }
     }
+    reset_abstract_state_ids();
     Oracle::initialize();
 }
 
+void NumericDominanceOracle::reset_abstract_state_ids() {
+    if (!cache_abstract_state_ids) {
+        return;
+    }
+    const int num_factors = read_simulation ? stripped_numeric_dominance_relation->size()
+                                            : numeric_dominance_relation->size();
+    abstract_state_ids = std::make_unique<PerStateArray<int>>(std::vector<int>(num_factors + 1, 0));
+}
+
+const int *NumericDominanceOracle::get_abstract_state_ids(const State &state) const {
+    assert(abstract_state_ids);
+    ArrayView<int> ids = (*abstract_state_ids)[state];
+    const int num_factors = ids.size() - 1;
+    if (!ids[num_factors]) {
+        ids[num_factors] = 1;
+        if (read_simulation) {
+            stripped_numeric_dominance_relation->get_abstract_state_ids(state, &ids[0]);
+        } else {
+            numeric_dominance_relation->get_abstract_state_ids(state, &ids[0]);
+        }
+    }
+    return &ids[0];
+}
+
 bool NumericDominanceOracle::confirm_dominance_value(const State &dominated_state, const State &dominating_state,
                                                      int dominance_value) const {
     assert(engine_);
@@ -306,6 +407,23 @@ NumericDominanceOracle::add_options_to_feature(plugins::Feature &feature) {
     feature.add_option<bool>("read_simulation", "Read simulation from sim_file instead of computing it.", "false");
     feature.add_option<bool>("test_serialization", "Write simulation to disk, read it and make sure it coincides.",
                              "false");
+    feature.add_option<bool>("anytime",
+                             "Start testing with the dominance function over the abstractions of anytime_abs and "
+                             "compute the one over the abstractions of abs in the background. "
+                             "Tests switch to the latter as soon as it is available.",
+                             "false");
+    feature.add_option<std::shared_ptr<simulations::AbstractionBuilder>>(
+        "anytime_abs", "abstraction builder for the initial dominance function in anytime mode",
+        "builder_atomic()");
+    feature.add_option<bool>("cache_abstract_state_ids",
+                             "Store the abstract state ids of every state the dominance function is evaluated on "
+                             "(one int per factor and state).",
+                             "true");
+}
+
+TestResult NumericDominanceOracle::test_driver(Policy &policy, const PoolEntry &pool_entry) {
+    refresh_dominance_relation();
+    return Oracle::test_driver(policy, pool_entry);
 }
 
 TestResult NumericDominanceOracle::test(Policy &, const State &) {
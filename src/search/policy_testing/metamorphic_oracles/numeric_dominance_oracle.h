@@ -3,6 +3,12 @@
 #include "../oracle.h"
 #include "../simulations/numeric_dominance/numeric_dominance_relation.h"
 
+#include "../../per_state_array.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
 namespace simulations {
 class Abstraction;
 class AbstractionBuilder;
@@ -19,6 +25,7 @@ class NumericDominanceRelation;
 namespace policy_testing {
 class NumericDominanceOracle : public Oracle {
     friend class CompositeOracle;
+    friend class DominancePoolFilter;
     std::shared_ptr<simulations::AbstractionBuilder> abstraction_builder;
     std::vector<std::unique_ptr<simulations::Abstraction>> abstractions;
     std::shared_ptr<simulations::TauLabelManager<int>> tau_labels;
@@ -35,6 +42,32 @@ class NumericDominanceOracle : public Oracle {
     bool write_sim_and_exit;
     bool test_serialization;
 
+    /*
+     * Anytime mode: testing starts on the (sound) relation over the abstractions of coarse_abstraction_builder
+     * while the relation over the abstractions of abstraction_builder is computed in a background thread.
+     * The refined relation is handed over in refresh_dominance_relation() between two tests. The background thread
+     * works on its own copy of the thread-local simulation state (dead operators, number of threads) and stops
+     * early once cancel_refinement is set.
+     */
+    const bool anytime;
+    std::shared_ptr<simulations::AbstractionBuilder> coarse_abstraction_builder;
+    std::shared_ptr<simulations::TauLabelManager<int>> refined_tau_labels;
+    std::thread refinement_thread;
+    std::mutex refinement_mutex;
+    std::atomic<bool> refined_relation_available = false;
+    std::atomic<bool> cancel_refinement = false;
+    std::unique_ptr<simulations::LDSimulation> refined_ldSim;
+    std::vector<std::unique_ptr<simulations::Abstraction>> refined_abstractions;
+    std::unique_ptr<simulations::NumericDominanceRelation<int>> refined_numeric_dominance_relation;
+
+    /*
+     * Abstract state ids of registered states in all factors of the current relation, filled on first use so that
+     * repeated dominance queries on pool and policy states skip the abstraction lookups. The last entry of each
+     * array marks whether the ids have been computed.
+     */
+    const bool cache_abstract_state_ids;
+    mutable std::unique_ptr<PerStateArray<int>> abstract_state_ids;
+
 public:
     enum class LocalBugTest {NONE, ONE, ALL};
 
@@ -71,6 +104,33 @@ private:
      */
     BugValue complete_local_bug_test(Policy &policy, const State &s);
 
+    /**
+     * Builds the abstractions of the given builder and computes the numeric dominance relation on them.
+     * @note ld_sim and abs_storage own the abstractions the returned relation refers to.
+     */
+    std::unique_ptr<simulations::NumericDominanceRelation<int>> compute_dominance_relation(
+        const simulations::AbstractionBuilder &builder,
+        const std::shared_ptr<simulations::TauLabelManager<int>> &tau_label_mgr,
+        std::unique_ptr<simulations::LDSimulation> &ld_sim,
+        std::vector<std::unique_ptr<simulations::Abstraction>> &abs_storage) const;
+
+    /**
+     * Computes the relation over the abstractions of abstraction_builder (runs in refinement_thread).
+     * @param dead_operators the dead operators found so far by the thread that started the refinement
+     */
+    void refine_dominance_relation(std::vector<bool> dead_operators);
+
+    /**
+     * (Re-)creates the abstract state id cache for the current relation.
+     */
+    void reset_abstract_state_ids();
+
+    /**
+     * @return the abstract state ids of the registered state in all factors of the current relation
+     * (-1 for factors in which the state is pruned).
+     */
+    [[nodiscard]] const int *get_abstract_state_ids(const State &state) const;
+
 protected:
     using DominanceValue = int;
     std::unique_ptr<simulations::NumericDominanceRelation<DominanceValue>> numeric_dominance_relation;
@@ -79,10 +139,19 @@ protected:
     // lower bound for the lowest negative but finite dominance value
     int minimal_finite_dominance_value = 0;
 
+    // incremented whenever the relation is replaced (anytime mode)
+    int dominance_relation_version = 0;
+
     bool read_simulation;
 
     void initialize() override;
 
+    /**
+     * In anytime mode, replaces the current relation by the refined one once the background computation is done.
+     * Must be called between tests only, i.e., not while dominance values of the old relation are in use.
+     */
+    void refresh_dominance_relation();
+
     /**
      * Debug method to confirm dominance value.
      * @warning inefficient. Only use for debugging purposes.
@@ -99,6 +168,15 @@ protected:
      * @note order of states is switched compared to q_dominates_value
      */
     [[nodiscard]] int D(const State &state0, const State &state1) const {
+        if (abstract_state_ids && state0.get_registry() && state1.get_registry()) {
+            const int *ids0 = get_abstract_state_ids(state0);
+            const int *ids1 = get_abstract_state_ids(state1);
+            if (read_simulation) {
+                return stripped_numeric_dominance_relation->q_dominates_value_by_ids(ids1, ids0);
+            } else {
+                return numeric_dominance_relation->q_dominates_value_by_ids(ids1, ids0);
+            }
+        }
         if (read_simulation) {
             assert(stripped_numeric_dominance_relation);
             return stripped_numeric_dominance_relation->q_dominates_value(state1, state0);
@@ -135,9 +213,12 @@ public:
     bool could_be_based_on_atomic_abstraction();
 
     explicit NumericDominanceOracle(const plugins::Options &opts);
+    ~NumericDominanceOracle() override;
 
     static void add_options_to_feature(plugins::Feature &feature);
 
+    TestResult test_driver(Policy &policy, const PoolEntry &pool_entry) override;
+
     TestResult test(Policy &policy, const State &state) override;
 };
 } // namespace policy_testing
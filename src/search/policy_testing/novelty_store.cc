@@ -6,8 +6,6 @@
 #include <cassert>
 #include <iostream>
 
-#define DMSG(x)
-
 namespace policy_testing {
 struct VarsetIterator {
     explicit VarsetIterator(unsigned num_vars, unsigned varset_size)
@@ -49,8 +47,7 @@ NoveltyStore::NoveltyStore(
     const std::shared_ptr<AbstractTask> &task)
     : max_arity_(std::min(static_cast<unsigned>(task->get_num_variables()), max_arity))
       , domains_(task->get_num_variables())
-      , offsets_(max_arity_)
-      , fact_sets_(max_arity_) {
+      , offsets_(max_arity_) {
     if (max_arity_ > 0) {
         for (int i = static_cast<int>(domains_.size()) - 1; i >= 0; --i) {
             domains_[i] = task->get_variable_domain_size(i);
@@ -70,26 +67,164 @@ NoveltyStore::NoveltyStore(
                 offset += product;
                 offsets_[i].push_back(offset);
             } while (varsets.next());
+            fact_sets_.emplace_back(offset);
+        }
+    }
+}
+
+NoveltyStore::FactSetCounts::FactSetCounts(FactSetType num_fact_sets)
+    : dense_(num_fact_sets <= MAX_DENSE_FACT_SETS) {
+    if (dense_) {
+        counts_.assign(num_fact_sets, 0);
+    } else {
+        keys_.assign(1024, EMPTY_KEY);
+        counts_.assign(1024, 0);
+        mask_ = 1023;
+    }
+}
+
+std::size_t
+NoveltyStore::FactSetCounts::find_slot(FactSetType fact_set) const {
+    // splitmix64 finalizer
+    FactSetType hash = fact_set;
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+    hash ^= hash >> 31;
+    std::size_t slot = hash & mask_;
+    while (keys_[slot] != EMPTY_KEY && keys_[slot] != fact_set) {
+        slot = (slot + 1) & mask_;
+    }
+    return slot;
+}
+
+void
+NoveltyStore::FactSetCounts::grow() {
+    std::vector<FactSetType> old_keys(keys_.size() * 2, EMPTY_KEY);
+    std::vector<std::uint8_t> old_counts(counts_.size() * 2, 0);
+    old_keys.swap(keys_);
+    old_counts.swap(counts_);
+    mask_ = keys_.size() - 1;
+    for (std::size_t i = 0; i < old_keys.size(); ++i) {
+        if (old_keys[i] != EMPTY_KEY) {
+            const std::size_t slot = find_slot(old_keys[i]);
+            keys_[slot] = old_keys[i];
+            counts_[slot] = old_counts[i];
         }
     }
 }
 
+bool
+NoveltyStore::FactSetCounts::insert(FactSetType fact_set) {
+    std::size_t slot = fact_set;
+    if (!dense_) {
+        assert(fact_set != EMPTY_KEY);
+        if (2 * (size_ + 1) > keys_.size()) {
+            grow();
+        }
+        slot = find_slot(fact_set);
+        keys_[slot] = fact_set;
+    }
+    assert(slot < counts_.size());
+    std::uint8_t &count = counts_[slot];
+    if (count == 0) {
+        count = 1;
+        ++size_;
+        return true;
+    }
+    count = 2;
+    return false;
+}
+
+bool
+NoveltyStore::FactSetCounts::contains(FactSetType fact_set) const {
+    return count(fact_set) > 0;
+}
+
+unsigned
+NoveltyStore::FactSetCounts::count(FactSetType fact_set) const {
+    if (dense_) {
+        assert(fact_set < counts_.size());
+        return counts_[fact_set];
+    }
+    return counts_[find_slot(fact_set)];
+}
+
+template<typename F>
+bool
+NoveltyStore::for_each_fact_set(const std::vector<int> &values, unsigned arity, F f) const {
+    assert(arity > 0 && arity <= max_arity_);
+    const std::vector<FactSetType> &offsets = offsets_[arity - 1];
+    const unsigned num_vars = domains_.size();
+    if (arity == 1) {
+        for (unsigned var = 0; var < num_vars; ++var) {
+            if (!f(offsets[var] + values[var])) {
+                return false;
+            }
+        }
+        return true;
+    }
+    if (arity == 2) {
+        // the ids of all pairs with the same first variable are computed in one contiguous sweep
+        std::size_t idx = 0;
+        for (unsigned var0 = 0; var0 + 1 < num_vars; ++var0) {
+            const FactSetType value0 = values[var0];
+            const FactSetType domain0 = domains_[var0];
+            for (unsigned var1 = var0 + 1; var1 < num_vars; ++var1, ++idx) {
+                if (!f(offsets[idx] + value0 + domain0 * values[var1])) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+    std::vector<unsigned> &vars = varset_;
+    vars.resize(arity);
+    for (unsigned i = 0; i < arity; ++i) {
+        vars[i] = i;
+    }
+    for (std::size_t idx = 0;; ++idx) {
+        FactSetType res = offsets[idx];
+        FactSetType product = 1;
+        for (unsigned j = 0; j < arity; ++j) {
+            res += product * values[vars[j]];
+            product *= domains_[vars[j]];
+        }
+        if (!f(res)) {
+            return false;
+        }
+        int i = static_cast<int>(arity) - 1;
+        while (i >= 0 && vars[i] == num_vars - arity + i) {
+            --i;
+        }
+        if (i < 0) {
+            return true;
+        }
+        ++vars[i];
+        for (unsigned j = i + 1; j < arity; ++j) {
+            vars[j] = vars[j - 1] + 1;
+        }
+    }
+}
+
+const std::vector<int> &
+NoveltyStore::read_values(const State &state) const {
+    values_.resize(state.size());
+    for (std::size_t var = 0; var < values_.size(); ++var) {
+        values_[var] = state[var].get_value();
+    }
+    return values_;
+}
+
 int
 NoveltyStore::compute_novelty(const State &state) {
+    const std::vector<int> &values = read_values(state);
     for (unsigned i = 0; i < max_arity_; ++i) {
-        VarsetIterator varsets(domains_.size(), i + 1);
-        do {
-            const auto &vars = *varsets;
-            FactSetType res = offsets_[i][varsets.get_idx()];
-            FactSetType product = 1;
-            for (unsigned j = 0; j <= i; ++j) {
-                res += product * state[vars[j]].get_value();
-                product *= domains_[vars[j]];
-            }
-            if (!fact_sets_[i].count(res)) {
-                return static_cast<int>(i) + 1;
-            }
-        } while (varsets.next());
+        const FactSetCounts &fact_sets = fact_sets_[i];
+        if (!for_each_fact_set(values, i + 1, [&fact_sets](FactSetType fact_set) {
+                                   return fact_sets.contains(fact_set);
+                               })) {
+            return static_cast<int>(i) + 1;
+        }
     }
     return 0;
 }
@@ -97,57 +232,24 @@ NoveltyStore::compute_novelty(const State &state) {
 
 bool
 NoveltyStore::insert(const State &state) {
+    const std::vector<int> &values = read_values(state);
     bool is_novel = false;
     for (unsigned i = 0; i < max_arity_; ++i) {
-        VarsetIterator varsets(domains_.size(), i + 1);
-        do {
-            const auto &vars = *varsets;
-            FactSetType res = offsets_[i][varsets.get_idx()];
-            FactSetType product = 1;
-            for (unsigned j = 0; j <= i; ++j) {
-                res += product * state[vars[j]].get_value();
-                assert(vars[j] < domains_.size());
-                product *= domains_[vars[j]];
-            }
-            auto inserted = fact_sets_[i].insert(std::pair<FactSetType, int>(res, 1));
-            if (inserted.second) {
-                DMSG(
-                    std::cout << "novel " << (i + 1) << "-fact-set: vars=[";
-                    for (unsigned var = 0; var < vars.size(); ++var) {
-                        std::cout << (var > 0 ? ", " : "") << vars[var];
-                    }
-                    std::cout << "] id=" << varsets.get_idx() << " hash=" << res << " values=[";
-                    for (unsigned var = 0; var < vars.size(); ++var) {
-                        std::cout << (var > 0 ? ", " : "") << state[vars[var]].get_name();
-                    }
-                    std::cout << "]" << std::endl;
-                    )
-                is_novel = true;
-            } else {
-                inserted.first->second = inserted.first->second + 1;
-            }
-        } while (varsets.next());
+        FactSetCounts &fact_sets = fact_sets_[i];
+        for_each_fact_set(values, i + 1, [&](FactSetType fact_set) {
+                              is_novel |= fact_sets.insert(fact_set);
+                              return true;
+                          });
     }
     return is_novel;
 }
 
 bool
 NoveltyStore::has_unique_factset(const State &state, unsigned arity) const {
-    VarsetIterator varsets(domains_.size(), arity);
-    do {
-        const auto &vars = *varsets;
-        FactSetType res = offsets_[arity - 1][varsets.get_idx()];
-        FactSetType product = 1;
-        for (unsigned j = 0; j < arity; ++j) {
-            res += product * state[vars[j]].get_value();
-            product *= domains_[vars[j]];
-        }
-        auto it = fact_sets_[arity - 1].find(res);
-        if (it->second == 1) {
-            return true;
-        }
-    } while (varsets.next());
-    return false;
+    const FactSetCounts &fact_sets = fact_sets_[arity - 1];
+    return !for_each_fact_set(read_values(state), arity, [&fact_sets](FactSetType fact_set) {
+                                  return fact_sets.count(fact_set) != 1;
+                              });
 }
 
 unsigned
@@ -169,5 +271,3 @@ NoveltyStore::print_statistics() const {
     }
 }
 } // namespace policy_testing
-
-#undef DMSG
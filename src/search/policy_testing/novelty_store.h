@@ -1,8 +1,7 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
-#include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
 class State;
@@ -27,9 +26,55 @@ public:
 
 private:
     using FactSetType = unsigned long long;
+
+    /*
+     * Occurrence counts (saturated at 2, which is all has_unique_factset needs) of the fact sets of one arity.
+     * Uses a dense array indexed by fact set if all fact sets of the arity fit into MAX_DENSE_FACT_SETS bytes and an
+     * open-addressing hash table otherwise.
+     */
+    class FactSetCounts {
+        static constexpr FactSetType EMPTY_KEY = ~FactSetType(0);
+        std::vector<std::uint8_t> counts_;
+        std::vector<FactSetType> keys_;
+        FactSetType mask_ = 0;
+        unsigned size_ = 0;
+        const bool dense_;
+
+        [[nodiscard]] std::size_t find_slot(FactSetType fact_set) const;
+        void grow();
+    public:
+        static constexpr FactSetType MAX_DENSE_FACT_SETS = FactSetType(1) << 26;
+
+        explicit FactSetCounts(FactSetType num_fact_sets);
+        // increments the count of fact_set and returns true iff it has not been seen before
+        bool insert(FactSetType fact_set);
+        [[nodiscard]] bool contains(FactSetType fact_set) const;
+        [[nodiscard]] unsigned count(FactSetType fact_set) const;
+        [[nodiscard]] unsigned size() const {return size_;}
+        [[nodiscard]] bool is_dense() const {return dense_;}
+    };
+
     const unsigned max_arity_;
     std::vector<unsigned> domains_;
     std::vector<std::vector<FactSetType>> offsets_;
-    std::vector<std::unordered_map<FactSetType, int>> fact_sets_;
+    std::vector<FactSetCounts> fact_sets_;
+    // scratch space for enumerating variable sets of arity > 2
+    mutable std::vector<unsigned> varset_;
+    // scratch space for the values of the state looked up at the moment
+    mutable std::vector<int> values_;
+
+    /**
+     * Reads the values of state into values_. Packed states are read in place instead of being unpacked, which
+     * would allocate a value vector for every lookup.
+     */
+    const std::vector<int> &read_values(const State &state) const;
+
+    /**
+     * Calls f on the id of every fact set of the given arity in the state (in the same order as VarsetIterator)
+     * until f returns false.
+     * @return false iff the enumeration was stopped by f
+     */
+    template<typename F>
+    bool for_each_fact_set(const std::vector<int> &values, unsigned arity, F f) const;
 };
 } // namespace policy_testing
@@ -103,7 +103,7 @@ void Oracle::report_parents_as_bugs(Policy &policy, const State &s, TestResult t
 
 TestResult
 Oracle::test_driver(Policy &policy, const PoolEntry &entry) {
-    const State &pool_state = entry.state;
+    const State pool_state = entry.get_state(get_state_registry());
     if (engine_->is_known_bug(pool_state) && !enforce_intermediate) {
         return engine_->get_stored_bug_result(pool_state);
     }
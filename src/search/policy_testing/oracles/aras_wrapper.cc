@@ -2,11 +2,13 @@
 
 #include "../utils.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
-#include <sstream>
+#include <optional>
 #include <string>
+#include <thread>
 #include <utility>
 #include <unistd.h>
 
@@ -60,20 +62,6 @@ ArasWrapper::call_aras(int time_limit) {
 #endif
 }
 
-bool
-ArasWrapper::load(const std::string &file_name, std::vector<OperatorID> &plan) {
-    std::ifstream aras_output(file_name);
-    if (!aras_output.good()) {
-        return false;
-    }
-    if (!plan_file_parser.parse(aras_output, plan)) {
-        utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
-    }
-    aras_output.close();
-    unlink(file_name.c_str());
-    return true;
-}
-
 bool
 ArasWrapper::improve_plan(
     int time_limit,
@@ -84,28 +72,33 @@ ArasWrapper::improve_plan(
 
     plan.clear();
 
-    std::vector<OperatorID> temp;
-    int best_cost = 0;
-
-    bool found = load("aras_sas_plan_output", plan);
-    if (found) {
-        best_cost = calculate_plan_cost(task, plan);
+    // Aras writes the first plan to aras_sas_plan_output and each improved plan to the next numbered file
+    std::vector<std::string> file_names;
+    for (int i = 0;; ++i) {
+        std::string file_name = "aras_sas_plan_output";
+        if (i > 0) {
+            file_name += "." + std::to_string(i);
+        }
+        if (access(file_name.c_str(), F_OK) != 0) {
+            break;
+        }
+        file_names.push_back(std::move(file_name));
     }
 
-    for (int i = 1;; ++i) {
-        std::ostringstream fname;
-        fname << "aras_sas_plan_output." << i;
-        bool res = load(fname.str(), temp);
-        if (res) {
-            const int cost = calculate_plan_cost(task, temp);
-            if (!found || cost < best_cost) {
-                best_cost = cost;
-                plan.swap(temp);
-                temp.clear();
-                found = true;
-            }
-        } else {
-            break;
+    const std::vector<std::optional<std::vector<OperatorID>>> plans =
+        plan_file_parser.parse_all(file_names, std::max(1U, std::thread::hardware_concurrency()));
+    bool found = false;
+    int best_cost = 0;
+    for (std::size_t i = 0; i < file_names.size(); ++i) {
+        if (!plans[i]) {
+            utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+        unlink(file_names[i].c_str());
+        const int cost = calculate_plan_cost(task, *plans[i]);
+        if (!found || cost < best_cost) {
+            best_cost = cost;
+            plan = *plans[i];
+            found = true;
         }
     }
 
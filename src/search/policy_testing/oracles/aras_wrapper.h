@@ -26,7 +26,6 @@ private:
     void
     prepare_aras_input(const State &state, const std::vector<OperatorID> &plan);
     void call_aras(int time_limit);
-    bool load(const std::string &file_name, std::vector<OperatorID> &plan);
 
     [[maybe_unused]] inline static void cleanup();
 
@@ -31,7 +31,8 @@ TestResult
 InvertibleDomainOracle::test_driver(Policy &policy, const PoolEntry &pool_entry) {
     // TODO: extend for non unit cost tasks, make explicit that it only works when policy solves initial state
     assert(task_properties::is_unit_cost(get_task_proxy()));
-    const PolicyCost lower_policy_cost_bound = policy.compute_lower_policy_cost_bound(pool_entry.state).first;
+    const State state = pool_entry.get_state(get_state_registry());
+    const PolicyCost lower_policy_cost_bound = policy.compute_lower_policy_cost_bound(state).first;
     TestResult test_result;
     if (lower_policy_cost_bound == Policy::UNSOLVED) {
         test_result = TestResult(UNSOLVED_BUG_VALUE);
@@ -41,7 +42,7 @@ InvertibleDomainOracle::test_driver(Policy &policy, const PoolEntry &pool_entry)
         const PolicyCost upper_ref_cost_bound =
             policy.read_upper_policy_cost_bound(get_state_registry().lookup_state(pool_entry.ref_state)).first;
         if (upper_ref_cost_bound == Policy::UNSOLVED) {
-            report_parents_as_bugs(policy, pool_entry.state, test_result);
+            report_parents_as_bugs(policy, state, test_result);
             return test_result;
         }
         const int alt_cost = upper_ref_cost_bound + pool_entry.steps;
@@ -64,7 +65,7 @@ InvertibleDomainOracle::test_driver(Policy &policy, const PoolEntry &pool_entry)
         }
     }
     if (report_parent_bugs) {
-        report_parents_as_bugs(policy, pool_entry.state, test_result);
+        report_parents_as_bugs(policy, state, test_result);
     }
     return test_result;
 }
@@ -1,59 +1,179 @@
 #include "plan_file_parser.h"
 
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cctype>
 #include <fstream>
+#include <iterator>
+#include <thread>
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace policy_testing {
-static std::string
-stolower(std::string s) {
-    std::transform(
-        s.begin(),
-        s.end(),
-        s.begin(),
-        [](unsigned char c) {return std::tolower(c);}   // correct
-        );
-    return s;
+static inline char
+lower(char c) {
+    return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
 }
 
 PlanFileParser::PlanFileParser(TaskProxy &task_proxy) {
-    for (OperatorProxy op : task_proxy.get_operators()) {
-        reverse_mapping_[stolower(op.get_name())] = op.get_id();
+    OperatorsProxy operators = task_proxy.get_operators();
+    name_offsets_.reserve(operators.size() + 1);
+    for (OperatorProxy op : operators) {
+        name_offsets_.push_back(names_.size());
+        for (char c : op.get_name()) {
+            names_.push_back(lower(c));
+        }
+    }
+    name_offsets_.push_back(names_.size());
+
+    std::size_t num_slots = 1;
+    while (num_slots < 2 * operators.size()) {
+        num_slots *= 2;
+    }
+    slots_.assign(num_slots, -1);
+    mask_ = num_slots - 1;
+    for (int op_id = 0; op_id < static_cast<int>(operators.size()); ++op_id) {
+        const std::string_view name = get_name(op_id);
+        std::size_t slot = hash(name) & mask_;
+        while (slots_[slot] != -1 && get_name(slots_[slot]) != name) {
+            slot = (slot + 1) & mask_;
+        }
+        // the last operator with this name wins
+        slots_[slot] = op_id;
+    }
+}
+
+std::uint64_t
+PlanFileParser::hash(std::string_view name) {
+    std::uint64_t h = 14695981039346656037ULL;
+    for (char c : name) {
+        h ^= static_cast<unsigned char>(lower(c));
+        h *= 1099511628211ULL;
     }
+    return h;
+}
+
+std::string_view
+PlanFileParser::get_name(int op_id) const {
+    return std::string_view(names_).substr(
+        name_offsets_[op_id], name_offsets_[op_id + 1] - name_offsets_[op_id]);
+}
+
+int
+PlanFileParser::lookup(std::string_view name) const {
+    for (std::size_t slot = hash(name) & mask_; slots_[slot] != -1; slot = (slot + 1) & mask_) {
+        const std::string_view candidate = get_name(slots_[slot]);
+        if (candidate.size() == name.size()
+            && std::equal(name.begin(), name.end(), candidate.begin(),
+                          [](char a, char b) {return lower(a) == b;})) {
+            return slots_[slot];
+        }
+    }
+    return -1;
 }
 
 bool
 PlanFileParser::parse(const std::string &path, std::vector<OperatorID> &plan)
 const {
-    std::ifstream f(path);
-    if (!f.good()) {
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
         return false;
     }
-    bool res = parse(f, plan);
-    f.close();
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0) {
+        close(fd);
+        return false;
+    }
+    const std::size_t size = file_stat.st_size;
+    if (size == 0) {
+        close(fd);
+        return true;
+    }
+    void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    const bool res = parse(std::string_view(static_cast<const char *>(data), size), plan);
+    munmap(data, size);
     return res;
+#else
+    std::ifstream f(path, std::ios::binary);
+    if (!f.good()) {
+        return false;
+    }
+    return parse(f, plan);
+#endif
 }
 
 bool
-PlanFileParser::parse(std::istream &in, std::vector<OperatorID> &result) const {
-    std::string operator_line;
-    while (std::getline(in, operator_line)) {
-        std::string op = stolower(operator_line);
-        auto pos = op.find(';');
-        if (pos != std::string::npos) {
-            op = op.substr(0, pos);
+PlanFileParser::parse(std::istream &in, std::vector<OperatorID> &plan) const {
+    const std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return parse(std::string_view(text), plan);
+}
+
+bool
+PlanFileParser::parse(std::string_view text, std::vector<OperatorID> &result) const {
+    while (!text.empty()) {
+        std::size_t line_end = text.find('\n');
+        if (line_end == std::string_view::npos) {
+            line_end = text.size();
         }
-        pos = op.find('(');
-        if (pos == std::string::npos) {
+        std::string_view line = text.substr(0, line_end);
+        text.remove_prefix(std::min(line_end + 1, text.size()));
+
+        line = line.substr(0, line.find(';'));
+        const std::size_t open = line.find('(');
+        if (open == std::string_view::npos) {
             continue;
         }
-        op = op.substr(op.find('(') + 1, op.find(')') - 1);
-        auto it = reverse_mapping_.find(op);
-        if (it == reverse_mapping_.end()) {
+        line.remove_prefix(open + 1);
+        const std::string_view op = line.substr(0, line.find(')'));
+        const int op_id = lookup(op);
+        if (op_id < 0) {
             std::cerr << "operator " << op << " not found" << std::endl;
             return false;
-        } else {
-            result.emplace_back(it->second);
         }
+        result.emplace_back(op_id);
     }
     return true;
 }
+
+std::vector<std::optional<std::vector<OperatorID>>>
+PlanFileParser::parse_all(const std::vector<std::string> &paths, int num_threads) const {
+    std::vector<std::optional<std::vector<OperatorID>>> plans(paths.size());
+    auto parse_file = [&](std::size_t i) {
+                          std::vector<OperatorID> plan;
+                          if (parse(paths[i], plan)) {
+                              plans[i] = std::move(plan);
+                          }
+                      };
+    num_threads = std::min<int>(num_threads, paths.size());
+    if (num_threads <= 1) {
+        for (std::size_t i = 0; i < paths.size(); ++i) {
+            parse_file(i);
+        }
+        return plans;
+    }
+    std::vector<std::thread> workers;
+    workers.reserve(num_threads);
+    for (int t = 0; t < num_threads; ++t) {
+        workers.emplace_back([&, t]() {
+                                 for (std::size_t i = t; i < paths.size(); i += num_threads) {
+                                     parse_file(i);
+                                 }
+                             });
+    }
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    return plans;
+}
 } // namespace policy_testing
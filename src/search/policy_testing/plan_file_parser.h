@@ -3,9 +3,12 @@
 #include "../operator_id.h"
 #include "../task_proxy.h"
 
+#include <cstdint>
 #include <iostream>
+#include <optional>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <vector>
 
 namespace policy_testing {
 class PlanFileParser {
@@ -13,10 +16,30 @@ public:
     explicit PlanFileParser(TaskProxy &task_proxy);
     ~PlanFileParser() = default;
 
+    // operator names are matched case-insensitively; if several operators share a name, the last one is used
     bool parse(const std::string &path, std::vector<OperatorID> &plan) const;
     bool parse(std::istream &in, std::vector<OperatorID> &plan) const;
+    bool parse(std::string_view text, std::vector<OperatorID> &plan) const;
+
+    /**
+     * Parses the plan files in paths using up to num_threads threads.
+     * @return the plan of every file or std::nullopt if the file could not be read or parsed
+     */
+    std::vector<std::optional<std::vector<OperatorID>>> parse_all(
+        const std::vector<std::string> &paths, int num_threads) const;
 
 private:
-    std::unordered_map<std::string, int> reverse_mapping_;
+    // lower-cased operator names, concatenated, and the offset of each operator's name (indexed by operator id)
+    std::string names_;
+    std::vector<std::uint32_t> name_offsets_;
+    // open-addressing hash table (linear probing) from lower-cased names to operator ids, -1 marks empty slots
+    std::vector<int> slots_;
+    std::size_t mask_ = 0;
+
+    // case-insensitive FNV-1a hash
+    static std::uint64_t hash(std::string_view name);
+    [[nodiscard]] std::string_view get_name(int op_id) const;
+    // returns the id of the operator with the given name (case-insensitive) or -1 if there is none
+    [[nodiscard]] int lookup(std::string_view name) const;
 };
 } // namespace policy_testing
@@ -37,15 +37,19 @@ HeuristicDescendPolicy::apply(const State &state) {
     }
     std::vector<OperatorID> aops;
     generate_applicable_ops(state, aops);
+    std::vector<State> successors;
+    successors.reserve(aops.size());
+    for (OperatorID op : aops) {
+        successors.push_back(get_successor_state(state, op));
+    }
+    std::vector<int> h_values;
+    heuristic_->compute_successor_values(state, successors, h_values);
     int best = -1;
     int h_best = strictly_descend_ ? h0 : std::numeric_limits<int>::max();
     for (int i = 0; i < aops.size(); ++i) {
-        State succ = get_successor_state(state, aops[i]);
-        EvaluationContext context(succ);
-        EvaluationResult r = heuristic_->compute_result(context);
-        if (r.get_evaluator_value() < h_best) {
+        if (h_values[i] < h_best) {
             best = i;
-            h_best = r.get_evaluator_value();
+            h_best = h_values[i];
         }
     }
     if (best < 0) {
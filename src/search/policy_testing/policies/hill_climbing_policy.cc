@@ -6,14 +6,14 @@
 #include "../../task_utils/task_properties.h"
 #include "../out_of_resource_exception.h"
 
-#include <deque>
 #include <vector>
 
 namespace policy_testing {
 HillClimbingPolicy::HillClimbingPolicy(const plugins::Options &opts)
     : Policy(opts)
       , heuristic_(opts.get<std::shared_ptr<Evaluator>>("eval"))
-      , helpful_actions_pruning_(opts.get<bool>("helpful_actions_pruning")) {
+      , helpful_actions_pruning_(opts.get<bool>("helpful_actions_pruning"))
+      , search_generation_(0) {
 }
 
 void
@@ -25,25 +25,11 @@ HillClimbingPolicy::add_options_to_feature(plugins::Feature &feature) {
 
 OperatorID
 HillClimbingPolicy::apply(const State &state0) {
-    struct ParentInfo {
-        StateID parent_id;
-        int op_idx;
-        explicit ParentInfo()
-            : parent_id(StateID::no_state)
-              , op_idx(-1) {
-        }
-        explicit ParentInfo(StateID p, int o)
-            : parent_id(p)
-              , op_idx(o) {
-        }
-    };
-
-    utils::HashMap<StateID, ParentInfo> closed;
-    closed.emplace(
-        std::pair<StateID, ParentInfo>(state0.get_id(), ParentInfo()));
-
-    std::deque<State> open;
-    open.push_back(state0);
+    ++search_generation_;
+    closed_[state0] = ClosedEntry(search_generation_);
+    open_.clear();
+    open_.push_back(state0);
+    plateau_.clear();
 
     int to_beat = -1;
 
@@ -51,12 +37,12 @@ HillClimbingPolicy::apply(const State &state0) {
 
     StateID exit = StateID::no_state;
 
-    while (!open.empty()) {
-        State state = open.front();
-        open.pop_front();
+    for (std::size_t head = 0; head < open_.size() && exit == StateID::no_state; ++head) {
+        const State state = open_[head];
         // evaluate only upon expansion as otherwise heuristic would need to be
         // recomputed if helpful actions pruning is activated
-        EvaluationContext context(state, nullptr, true);
+        // (preferred operators are only requested if needed so that the heuristic may use its cache)
+        EvaluationContext context(state, nullptr, helpful_actions_pruning_);
         const EvaluationResult h = heuristic_->compute_result(context);
         if (h.is_infinite()) {
             continue;
@@ -67,6 +53,9 @@ HillClimbingPolicy::apply(const State &state0) {
             exit = state.get_id();
             break;
         }
+        if (h.get_evaluator_value() == to_beat) {
+            plateau_.push_back(state.get_id());
+        }
         if (are_limits_reached()) {
             throw OutOfResourceException();
         }
@@ -81,30 +70,42 @@ HillClimbingPolicy::apply(const State &state0) {
         }
         for (auto &aop : aops) {
             State succ = get_successor_state(state, aop);
-            if (closed
-                .emplace(std::pair<StateID, ParentInfo>(
-                             succ.get_id(),
-                             ParentInfo(state.get_id(), aop.get_index())))
-                .second) {
+            ClosedEntry &entry = closed_[succ];
+            if (entry.generation != search_generation_) {
+                entry = ClosedEntry(search_generation_, state.get_id(), aop.get_index());
                 if (task_properties::is_goal_state(get_task_proxy(), succ)) {
                     exit = succ.get_id();
-                    open.clear();
                     break;
                 }
-                open.push_back(succ);
+                open_.push_back(succ);
             }
         }
         aops.clear();
     }
 
     if (exit == StateID::no_state) {
+        /*
+          Every state reachable from a plateau state expanded in this search
+          has been expanded as well and none of them beats the plateau value,
+          so the search fails from each of them. With helpful actions pruning,
+          cached actions may lead out of the explored part, so nothing is
+          concluded then.
+        */
+        if (!helpful_actions_pruning_) {
+            for (StateID id : plateau_) {
+                const State state = get_state_registry().lookup_state(id);
+                if (!can_lookup_action(state)) {
+                    store_operator(state, NO_OPERATOR);
+                }
+            }
+        }
         return NO_OPERATOR;
     }
 
     OperatorID result = NO_OPERATOR;
     while (exit != state0.get_id()) {
-        assert(closed.find(exit) != closed.end());
-        const ParentInfo &info = closed[exit];
+        const ClosedEntry &info = closed_[get_state_registry().lookup_state(exit)];
+        assert(info.generation == search_generation_);
         store_operator(
             get_state_registry().lookup_state(info.parent_id),
             OperatorID(info.op_idx));
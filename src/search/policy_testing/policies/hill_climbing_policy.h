@@ -3,6 +3,7 @@
 #include "../policy.h"
 
 #include <memory>
+#include <vector>
 
 class Evaluator;
 
@@ -12,6 +13,10 @@ namespace policy_testing {
  * state with strictly smaller heuristic value. The found path is stored in the
  * policy cache so that sub-sequent apply calls will iteratively walk along this
  * path.
+ * The search data structures are kept across apply calls: the closed list is
+ * a per-state table whose entries are only valid for the search that stamped
+ * them with its generation. If a search fails, the policy fails in all states
+ * of the explored plateau as well, which is stored in the policy cache.
  **/
 class HillClimbingPolicy : public Policy {
 public:
@@ -22,7 +27,26 @@ protected:
     OperatorID apply(const State &state) override;
 
 private:
+    struct ClosedEntry {
+        // the entry belongs to the current search iff generation == search_generation_
+        unsigned generation;
+        StateID parent_id;
+        int op_idx;
+        explicit ClosedEntry(unsigned generation = 0, StateID parent_id = StateID::no_state, int op_idx = -1)
+            : generation(generation)
+              , parent_id(parent_id)
+              , op_idx(op_idx) {
+        }
+    };
+
     std::shared_ptr<Evaluator> heuristic_;
     const bool helpful_actions_pruning_;
+
+    PerStateInformation<ClosedEntry> closed_;
+    unsigned search_generation_;
+    // FIFO queue of the breadth-first search, states before the head index have been expanded
+    std::vector<State> open_;
+    // expanded states with the heuristic value of the start state
+    std::vector<StateID> plateau_;
 };
 } // namespace policy_testing
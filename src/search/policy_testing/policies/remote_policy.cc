@@ -1,6 +1,7 @@
 #include "remote_policy.h"
 
 #include "../../plugins/plugin.h"
+#include <chrono>
 #include <utility>
 
 namespace policy_testing {
@@ -54,14 +55,7 @@ std::string RemotePolicy::input_fdr() {
     return out;
 }
 
-OperatorID RemotePolicy::static_apply(const State &state_in) {
-    if (!connection_established()) {
-        throw RemotePolicyError("No connection to remote policy established.\n"
-                                "Make sure your FD call starts with --remote-policy <url>.");
-    }
-    const std::vector<int> &state = state_in.get_values();
-    int op_id =
-        phrmPolicyFDRStateOperator(pheromone_policy, state.data(), state.size());
+OperatorID RemotePolicy::to_operator_id(int op_id) {
     if (op_id >= 0) {
         return OperatorID(op_id);
     } else if (op_id == -1) {
@@ -72,8 +66,35 @@ OperatorID RemotePolicy::static_apply(const State &state_in) {
     }
 }
 
+int RemotePolicy::send_query(const State &state_in) {
+    if (!connection_established()) {
+        throw RemotePolicyError("No connection to remote policy established.\n"
+                                "Make sure your FD call starts with --remote-policy <url>.");
+    }
+    const std::vector<int> &state = state_in.get_values();
+    return phrmPolicyFDRStateOperator(pheromone_policy, state.data(), state.size());
+}
+
+OperatorID RemotePolicy::static_apply(const State &state_in) {
+    return to_operator_id(send_query(state_in));
+}
+
+int RemotePolicy::query_operator(const State &state_in) {
+    return send_query(state_in);
+}
+
 OperatorID RemotePolicy::apply(const State &state_in) {
-    return static_apply(state_in);
+    const auto start = std::chrono::steady_clock::now();
+    const int op_id = query_operator(state_in);
+    ++num_queries_;
+    query_time_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return to_operator_id(op_id);
+}
+
+void RemotePolicy::print_statistics() const {
+    std::cout << "Policy queries: " << num_queries_ << std::endl;
+    std::cout << "Policy query time: " << query_time_ << "s" << std::endl;
+    std::cout << "Policy queries per second: " << (query_time_ > 0 ? num_queries_ / query_time_ : 0.0) << std::endl;
 }
 
 RemotePolicyPruning::RemotePolicyPruning(const plugins::Options &opts) : PruningMethod(opts) {}
@@ -49,6 +49,27 @@ public:
      */
     OperatorID apply(const State &state) override;
     static OperatorID static_apply(const State &state);
+
+    void print_statistics() const override;
+
+protected:
+    /**
+     * Sends the state to the policy server and returns the id of the selected operator, or -1 if the policy does
+     * not select an operator.
+     */
+    virtual int query_operator(const State &state);
+
+    // number of queries so far
+    unsigned long long get_num_queries() const {return num_queries_;}
+    // wall-clock time spent in queries so far in seconds
+    double get_query_time() const {return query_time_;}
+
+private:
+    unsigned long long num_queries_ = 0;
+    double query_time_ = 0;
+
+    static int send_query(const State &state);
+    static OperatorID to_operator_id(int op_id);
 };
 
 
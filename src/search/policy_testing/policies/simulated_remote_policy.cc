@@ -0,0 +1,57 @@
+#include "simulated_remote_policy.h"
+
+#include "../../plugins/plugin.h"
+
+#include <chrono>
+#include <thread>
+
+namespace policy_testing {
+SimulatedRemotePolicy::SimulatedRemotePolicy(const plugins::Options &opts)
+    : RemotePolicy(opts)
+      , policy_(opts.get<std::shared_ptr<Policy>>("policy"))
+      , latency_(opts.get<double>("latency") * 1000.0)
+      , jitter_(opts.get<double>("jitter") * 1000.0)
+      , rng_(opts.get<int>("seed")) {
+    register_sub_component(policy_.get());
+}
+
+void
+SimulatedRemotePolicy::add_options_to_feature(plugins::Feature &feature) {
+    RemotePolicy::add_options_to_feature(feature);
+    feature.add_option<std::shared_ptr<Policy>>("policy", "built-in policy answering the queries");
+    feature.add_option<double>("latency", "latency of each query in milliseconds", "1.0",
+                               plugins::Bounds("0.0", "infinity"));
+    feature.add_option<double>("jitter",
+                               "maximal deviation from the latency in milliseconds (uniformly distributed)", "0.0",
+                               plugins::Bounds("0.0", "infinity"));
+    feature.add_option<int>("seed", "", "1734");
+}
+
+int
+SimulatedRemotePolicy::query_operator(const State &state) {
+    const double delay = std::max(0.0, latency_ + jitter_ * (2.0 * rng_.random() - 1.0));
+    std::this_thread::sleep_for(std::chrono::duration<double, std::micro>(delay));
+    simulated_latency_ += delay / 1e6;
+    const OperatorID op = delegate_apply(*policy_, state);
+    return op == OperatorID::no_operator ? -1 : op.get_index();
+}
+
+void
+SimulatedRemotePolicy::print_statistics() const {
+    RemotePolicy::print_statistics();
+    const double overhead = std::max(0.0, get_query_time() - simulated_latency_);
+    std::cout << "Simulated policy latency: " << simulated_latency_ << "s" << std::endl;
+    std::cout << "Policy query overhead: " << overhead << "s" << std::endl;
+    const unsigned long long num_queries = get_num_queries();
+    std::cout << "Policy query overhead per query: " << (num_queries > 0 ? overhead / num_queries : 0.0) << "s"
+              << std::endl;
+}
+
+class SimulatedRemotePolicyFeature : public plugins::TypedFeature<Policy, SimulatedRemotePolicy> {
+public:
+    SimulatedRemotePolicyFeature() : TypedFeature("simulated_remote_policy") {
+        SimulatedRemotePolicy::add_options_to_feature(*this);
+    }
+};
+static plugins::FeaturePlugin<SimulatedRemotePolicyFeature> _plugin;
+} // namespace policy_testing
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "remote_policy.h"
+#include "../../utils/rng.h"
+
+#include <memory>
+
+namespace policy_testing {
+/**
+ * Offline stand-in for a remote policy: answers each query with the action of a built-in policy after waiting
+ * for a configurable latency (plus uniformly distributed jitter), mimicking the round trip to a policy server.
+ * Queries go through the same code path as those of a RemotePolicy, which reports the number of queries and the
+ * wall-clock query throughput, so that batching and caching changes can be evaluated reproducibly without a policy
+ * server. In addition, the query overhead without the simulated latency is reported.
+ **/
+class SimulatedRemotePolicy : public RemotePolicy {
+public:
+    explicit SimulatedRemotePolicy(const plugins::Options &opts);
+    static void add_options_to_feature(plugins::Feature &feature);
+
+    void print_statistics() const override;
+
+protected:
+    int query_operator(const State &state) override;
+
+private:
+    std::shared_ptr<Policy> policy_;
+    // latency and maximal jitter per query in microseconds
+    const double latency_;
+    const double jitter_;
+    utils::RandomNumberGenerator rng_;
+
+    // simulated latency of all queries in seconds
+    double simulated_latency_ = 0;
+};
+} // namespace policy_testing
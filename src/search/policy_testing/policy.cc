@@ -231,6 +231,28 @@ Policy::has_complete_cached_path(const State &state0) {
     return true;
 }
 
+std::vector<State> Policy::read_cached_path(const State &state0) const {
+    utils::HashSet<StateID> seen;
+    std::vector<State> path;
+    seen.insert(state0.get_id());
+    State state = state0;
+    while (true) {
+        path.push_back(state);
+        if (task_properties::is_goal_state(get_task_proxy(), state) || !can_lookup_action(state)) {
+            break;
+        }
+        OperatorID op = lookup_action(state);
+        if (op == NO_OPERATOR) {
+            break;
+        }
+        state = get_successor_state(state, op);
+        if (!seen.insert(state.get_id()).second) {
+            break;
+        }
+    }
+    return path;
+}
+
 std::vector<State> Policy::execute_get_path_fragment(const State &state0,
                                                      std::optional<unsigned int> step_limit_override,
                                                      bool continue_with_cached_actions) {
@@ -148,6 +148,13 @@ public:
      */
     bool has_complete_cached_path(const State &state);
 
+    /**
+     * Returns the path obtained by following cached actions from the given state (including the state itself).
+     * Stops at goal states, states without cached action, dead ends and loops.
+     * @note never executes the policy
+     */
+    std::vector<State> read_cached_path(const State &state) const;
+
     /**
      * Executes the policy and returns a path fragment.
      * @note compliant with steps_limit field (execution is aborted if steps_limit is reached)
@@ -296,6 +303,8 @@ public:
      */
     [[nodiscard]] PolicyCost get_operator_cost(OperatorID op) const;
 
+    virtual void print_statistics() const { }
+
     static void add_options_to_feature(plugins::Feature &feature);
 
 protected:
@@ -319,6 +328,13 @@ protected:
      **/
     virtual OperatorID apply(const State &state) = 0;
 
+    /**
+     * Calls apply of another policy, e.g., one wrapped by this policy. Bypasses the action cache of the other policy.
+     **/
+    static OperatorID delegate_apply(Policy &policy, const State &state) {
+        return policy.apply(state);
+    }
+
     /**
      * Set the chosen-action-cache entry of the given state to the given action id.
      **/
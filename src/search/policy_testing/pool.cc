@@ -27,10 +27,6 @@ PoolFile::write(int ref_index, int steps, const State &state) {
     out_ << std::endl;
 }
 
-void PoolFile::write(const PoolEntry &entry) {
-    write(entry.ref_index, entry.steps, entry.state);
-}
-
 Pool
 load_pool_file(
     const std::shared_ptr<AbstractTask> &task,
@@ -90,7 +86,7 @@ parse_pool_entries(
         }
         values.push_back(std::stoi(s.substr(c + 1)));
         State state = state_registry.insert_state(values);
-        result.emplace_back(ref, ref >= 0 ? result[ref].state.get_id() : StateID::no_state, steps, state);
+        result.emplace_back(ref, ref >= 0 ? result[ref].get_state_id() : StateID::no_state, steps, state);
     }
     std::cout << "... loaded " << result.size() << " entries" << std::endl;
     return result;
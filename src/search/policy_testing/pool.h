@@ -2,6 +2,7 @@
 
 #include "../state_registry.h"
 
+#include <cassert>
 #include <fstream>
 #include <iostream>
 #include <memory>
@@ -19,19 +20,28 @@ struct PoolEntry {
     int ref_index;
     /** Number of actions applied to the back-referenced state (length of random walk). **/
     int steps;
-    /** The actual pool state of this entry */
-    State state;
 
-    PoolEntry(int ref_index, StateID ref, int steps, State s)
-        : ref_state(ref), ref_index(ref_index), steps(steps), state(std::move(s)) {
+    PoolEntry(int ref_index, StateID ref, int steps, const State &s)
+        : ref_state(ref), ref_index(ref_index), steps(steps), state_id(s.get_id()) {
+        assert(s.get_registry());
     }
 
-    PoolEntry(int ref_index, int steps, State s, const std::vector<PoolEntry> &pool)
-        : ref_state(ref_index < 0 ? StateID::no_state : pool[ref_index].state.get_id())
-          , ref_index(ref_index)
-          , steps(steps),
-          state(std::move(s)) {
+    PoolEntry(int ref_index, int steps, const State &s, const std::vector<PoolEntry> &pool)
+        : PoolEntry(ref_index, ref_index < 0 ? StateID::no_state : pool[ref_index].state_id, steps, s) {
     }
+
+    /** The actual pool state of this entry (packed only, looked up in the registry of the pool) */
+    [[nodiscard]] State get_state(const StateRegistry &registry) const {
+        return registry.lookup_state(state_id);
+    }
+
+    [[nodiscard]] StateID get_state_id() const {
+        return state_id;
+    }
+
+private:
+    // only the id is stored so that pool entries never keep copies of unpacked state values
+    StateID state_id;
 };
 
 using Pool = std::vector<PoolEntry>;
@@ -44,7 +54,6 @@ public:
     ~PoolFile() = default;
 
     void write(int ref_index, int steps, const State &state);
-    void write(const PoolEntry &entry);
 
 private:
     std::ofstream out_;
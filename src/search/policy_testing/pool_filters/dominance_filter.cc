@@ -0,0 +1,213 @@
+#include "dominance_filter.h"
+
+#include "../metamorphic_oracles/numeric_dominance_oracle.h"
+
+#include "../../plugins/plugin.h"
+
+namespace policy_testing {
+DominancePoolFilter::DominancePoolFilter(const plugins::Options &opts)
+    : dominance_oracle(std::dynamic_pointer_cast<NumericDominanceOracle>(opts.get<std::shared_ptr<Oracle>>("dominance"))),
+      margin(opts.get<int>("margin")),
+      rejection_probability(opts.get<double>("rejection_probability")),
+      max_comparisons(static_cast<unsigned int>(std::max(opts.get<int>("max_comparisons"), 0))),
+      rng(opts.get<int>("seed")) {
+    if (!dominance_oracle) {
+        std::cerr << "dominance_filter requires a numeric dominance oracle." << std::endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+    register_sub_component(dominance_oracle.get());
+}
+
+void
+DominancePoolFilter::initialize() {
+    if (initialized) {
+        return;
+    }
+    PoolFilter::initialize();
+}
+
+void
+DominancePoolFilter::add_options_to_feature(plugins::Feature &feature) {
+    feature.add_option<std::shared_ptr<Oracle>>(
+        "dominance",
+        "numeric dominance oracle providing the dominance function "
+        "(use let to share it with the testing method)");
+    feature.add_option<int>("margin",
+                            "candidate t is considered dominated by pool state s if D(t, s) >= -margin",
+                            "0");
+    feature.add_option<double>("rejection_probability",
+                               "probability with which a dominated candidate is rejected",
+                               "1.0");
+    feature.add_option<int>("max_comparisons",
+                            "maximal number of pool states to compare a candidate to",
+                            "1000000");
+    feature.add_option<int>("seed",
+                            "seed for the random rejection of dominated candidates and the choice of the index factor",
+                            "1734");
+}
+
+template<typename F>
+auto DominancePoolFilter::with_relation(F f) const {
+    if (dominance_oracle->read_simulation) {
+        assert(dominance_oracle->stripped_numeric_dominance_relation);
+        return f(*dominance_oracle->stripped_numeric_dominance_relation);
+    } else {
+        assert(dominance_oracle->numeric_dominance_relation);
+        return f(*dominance_oracle->numeric_dominance_relation);
+    }
+}
+
+int
+DominancePoolFilter::get_index_key(const State &state) const {
+    if (index_factor < 0) {
+        return 0;
+    }
+    if (dominance_oracle->abstract_state_ids && state.get_registry()) {
+        return dominance_oracle->get_abstract_state_ids(state)[index_factor];
+    }
+    return with_relation([&](const auto &relation) {
+                             return relation[index_factor].get_abstract_state_id(state);
+                         });
+}
+
+void
+DominancePoolFilter::update_index() {
+    if (indexed_relation_version == dominance_oracle->dominance_relation_version) {
+        return;
+    }
+    indexed_relation_version = dominance_oracle->dominance_relation_version;
+
+    /*
+      use the factor in which simulation is impossible for most pairs of abstract states; for large factors, this
+      number is estimated from a sample of the pairs
+    */
+    const auto [factor, num_keys] = with_relation([this](const auto &relation) {
+        int best_factor = -1;
+        unsigned int best_size = 1;
+        double best_impossible = 0;
+        for (int i = 0; i < relation.size(); ++i) {
+            const auto &simulation = relation[i];
+            const unsigned int size = simulation.num_abstract_states();
+            const unsigned long long num_pairs = static_cast<unsigned long long>(size) * size;
+            unsigned long long impossible = 0;
+            if (num_pairs <= MAX_SAMPLED_PAIRS) {
+                for (unsigned int s = 0; s < size; ++s) {
+                    for (unsigned int t = 0; t < size; ++t) {
+                        if (!simulation.may_simulate(s, t)) {
+                            ++impossible;
+                        }
+                    }
+                }
+            } else {
+                for (unsigned int sample = 0; sample < MAX_SAMPLED_PAIRS; ++sample) {
+                    if (!simulation.may_simulate(rng.random(size), rng.random(size))) {
+                        ++impossible;
+                    }
+                }
+            }
+            const unsigned long long num_checked_pairs = std::min<unsigned long long>(num_pairs, MAX_SAMPLED_PAIRS);
+            const double estimated_impossible = static_cast<double>(impossible) * num_pairs / num_checked_pairs;
+            if (best_factor < 0 || estimated_impossible > best_impossible) {
+                best_factor = i;
+                best_size = size;
+                best_impossible = estimated_impossible;
+            }
+        }
+        return std::make_pair(best_factor, best_size);
+    });
+    index_factor = factor;
+
+    may_simulate_abstract_states.assign(num_keys, {});
+    may_simulate_computed.assign(num_keys, false);
+    states_by_abstract_state.assign(num_keys, {});
+    for (StateID id : accepted_states) {
+        const int key = get_index_key(get_state_registry().lookup_state(id));
+        if (key >= 0) {
+            states_by_abstract_state[key].push_back(id);
+        }
+    }
+}
+
+const std::vector<int> &
+DominancePoolFilter::get_may_simulate_abstract_states(int abstract_state) {
+    std::vector<int> &result = may_simulate_abstract_states[abstract_state];
+    if (!may_simulate_computed[abstract_state]) {
+        may_simulate_computed[abstract_state] = true;
+        if (index_factor < 0) {
+            result.push_back(0);
+        } else {
+            with_relation([&](const auto &relation) {
+                              const auto &simulation = relation[index_factor];
+                              for (unsigned int s = 0; s < simulation.num_abstract_states(); ++s) {
+                                  if (simulation.may_simulate(s, abstract_state)) {
+                                      result.push_back(s);
+                                  }
+                              }
+                          });
+        }
+    }
+    return result;
+}
+
+bool
+DominancePoolFilter::is_dominated_by_pool_state(const State &state) {
+    const int key = get_index_key(state);
+    if (key < 0) {
+        // pruned in the index factor, no state can dominate it
+        return false;
+    }
+    unsigned int comparisons = 0;
+    for (int simulating_key : get_may_simulate_abstract_states(key)) {
+        for (StateID id : states_by_abstract_state[simulating_key]) {
+            if (comparisons++ >= max_comparisons) {
+                ++num_comparison_limit_reached;
+                return false;
+            }
+            ++num_comparisons;
+            // D(state, pool_state): value with which pool_state dominates state
+            const int dominance_value = dominance_oracle->D(state, get_state_registry().lookup_state(id));
+            if (dominance_value > simulations::MINUS_INFINITY && dominance_value >= -margin) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool
+DominancePoolFilter::store(const State &state) {
+    // the filter may be the only user of the oracle, so it has to pick up a refined relation itself
+    dominance_oracle->refresh_dominance_relation();
+    update_index();
+    if (is_dominated_by_pool_state(state)) {
+        ++num_dominated;
+        if (rejection_probability >= 1.0 || rng.random() < rejection_probability) {
+            ++num_rejected;
+            return false;
+        }
+    }
+    accepted_states.push_back(state.get_id());
+    const int key = get_index_key(state);
+    if (key >= 0) {
+        states_by_abstract_state[key].push_back(state.get_id());
+    }
+    return true;
+}
+
+void
+DominancePoolFilter::print_statistics() const {
+    std::cout << "Dominance filter: dominated candidates: " << num_dominated << std::endl;
+    std::cout << "Dominance filter: rejected candidates: " << num_rejected << std::endl;
+    std::cout << "Dominance filter: state comparisons: " << num_comparisons << std::endl;
+    std::cout << "Dominance filter: candidates with max_comparisons reached: " << num_comparison_limit_reached
+              << std::endl;
+}
+
+class DominancePoolFilterFeature : public plugins::TypedFeature<PoolFilter, DominancePoolFilter> {
+public:
+    DominancePoolFilterFeature() : TypedFeature("dominance_filter") {
+        DominancePoolFilter::add_options_to_feature(*this);
+    }
+};
+static plugins::FeaturePlugin<DominancePoolFilterFeature> _plugin;
+} // namespace policy_testing
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "../pool_filter.h"
+#include "../../utils/rng.h"
+
+#include <memory>
+#include <vector>
+
+namespace policy_testing {
+class NumericDominanceOracle;
+
+/**
+ * Rejects candidates that are dominated by a state already accepted into the pool, i.e., pool states s with
+ * D(candidate, s) >= -margin. Such candidates rarely reveal new bugs but cost a policy run and an oracle test.
+ * Pool states are indexed by their abstract state in the most selective factor of the dominance relation so
+ * that only pool states that may simulate the candidate in this factor are compared.
+ */
+class DominancePoolFilter : public PoolFilter {
+public:
+    explicit DominancePoolFilter(const plugins::Options &opts);
+    static void add_options_to_feature(plugins::Feature &feature);
+    bool store(const State &state) override;
+    void print_statistics() const override;
+
+protected:
+    void initialize() override;
+
+private:
+    std::shared_ptr<NumericDominanceOracle> dominance_oracle;
+    const int margin;
+    const double rejection_probability;
+    const unsigned int max_comparisons;
+    utils::RandomNumberGenerator rng;
+
+    // all accepted states (needed to rebuild the index if the oracle switches to a refined relation)
+    std::vector<StateID> accepted_states;
+
+    // version of the oracle's relation the index has been built for
+    int indexed_relation_version = -1;
+    // maximal number of pairs of abstract states checked per factor when choosing index_factor
+    static constexpr unsigned int MAX_SAMPLED_PAIRS = 10000;
+    // factor of the dominance relation whose abstract states are used as index keys
+    int index_factor = -1;
+    // accepted states by their abstract state in index_factor
+    std::vector<std::vector<StateID>> states_by_abstract_state;
+    // for every abstract state t in index_factor the abstract states that may simulate t (computed on demand)
+    std::vector<std::vector<int>> may_simulate_abstract_states;
+    std::vector<bool> may_simulate_computed;
+
+    unsigned long long num_dominated = 0;
+    unsigned long long num_rejected = 0;
+    unsigned long long num_comparisons = 0;
+    // candidates for which the comparison stopped at max_comparisons (they are accepted)
+    unsigned long long num_comparison_limit_reached = 0;
+
+    /**
+     * Calls f on the relation currently used by the oracle (computed or read from disk).
+     */
+    template<typename F>
+    auto with_relation(F f) const;
+    void update_index();
+    [[nodiscard]] int get_index_key(const State &state) const;
+    const std::vector<int> &get_may_simulate_abstract_states(int abstract_state);
+    [[nodiscard]] bool is_dominated_by_pool_state(const State &state);
+};
+} // namespace policy_testing
@@ -23,6 +23,7 @@
 
 namespace simulations {
 bool Abstraction::store_original_operators = false;
+thread_local int Abstraction::num_threads = 1;
 
 /* Implementation note: Transitions are grouped by their labels,
    not by source state or any such thing. Such a grouping is beneficial
@@ -992,14 +993,22 @@ CompositeAbstraction::CompositeAbstraction(Labels *labels, Abstraction *abs1, Ab
        abstraction has only self-loops, by looking at each transition of the
        first abstraction and multiplying in out with the transitions of the
        second transition, we obtain the desired order (a,c,d).
+       Hence, the transitions of each label are sorted in bulk once they are
+       generated, which keeps the product normalized.
     */
-    int multiplier = abs2->size();
+    // the Labels object is shared, so register relevance sequentially before the per-label work is distributed
     for (int label_no = 0; label_no < num_labels; label_no++) {
+        if (abs1->relevant_labels[label_no] || abs2->relevant_labels[label_no]) {
+            relevant_labels[label_no] = true;
+            labels->set_relevant_for(label_no, this);
+        }
+    }
+
+    int multiplier = abs2->size();
+    parallel_for(num_labels, num_threads, [&](int label_no) {
         bool relevant1 = abs1->relevant_labels[label_no];
         bool relevant2 = abs2->relevant_labels[label_no];
         if (relevant1 || relevant2) {
-            relevant_labels[label_no] = true;
-            labels->set_relevant_for(label_no, this);
             std::vector<AbstractTransition> &transitions = transitions_by_label[label_no];
             const std::vector<AbstractTransition> &bucket1 =
                 abs1->transitions_by_label[label_no];
@@ -1073,8 +1082,12 @@ CompositeAbstraction::CompositeAbstraction(Labels *labels, Abstraction *abs1, Ab
                 }
                 assert(is_sorted_unique(transitions));
             }
+            if (!store_original_operators) {
+                // bulk normalization of the label's transitions instead of a later normalize() of the whole abstraction
+                sort_unique(transitions);
+            }
         }
-    }
+    });
 
     // TODO do not check if transitions are sorted but just assume they are not?
     if (!are_transitions_sorted_unique())
@@ -1266,10 +1279,10 @@ void Abstraction::apply_abstraction(ShrinkStrategy::EquivalenceRelation &collaps
 
     std::vector<std::vector<boost::dynamic_bitset<>>> new_transitions_by_label_based_on_operators(
         transitions_by_label_based_on_operators.size());
-    for (int label_no = 0; label_no < num_labels; label_no++) {
+    parallel_for(num_labels, num_threads, [&](int label_no) {
         if (labels->is_label_reduced(label_no)) {
             // do not consider non-leaf labels
-            continue;
+            return;
         }
         const std::vector<AbstractTransition> &transitions =
             transitions_by_label[label_no];
@@ -1291,7 +1304,11 @@ void Abstraction::apply_abstraction(ShrinkStrategy::EquivalenceRelation &collaps
                 }
             }
         }
-    }
+        if (!store_original_operators && transitions_sorted_unique) {
+            // collapsing states may break the order and introduce duplicates
+            sort_unique(new_transitions);
+        }
+    });
     std::vector<std::vector<AbstractTransition>>().swap(transitions_by_label);
 
     if (store_original_operators) {
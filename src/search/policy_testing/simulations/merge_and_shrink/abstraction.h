@@ -75,6 +75,9 @@ class Abstraction {
     inline static constexpr const int DISTANCE_UNKNOWN = -2;
 
     static bool store_original_operators;
+    // number of threads used for product construction and shrinking (work is distributed over labels)
+    // thread-local because abstractions may be built in a background thread
+    static thread_local int num_threads;
 
     // There should only be one instance of Labels at runtime. It is created
     // and managed by MergeAndShrinkHeuristic. All abstraction instances have
@@ -182,6 +185,14 @@ public:
     static void build_atomic_abstractions(std::vector<Abstraction *> &result,
                                           Labels *labels);
 
+    static void set_num_threads(int threads) {
+        num_threads = std::max(threads, 1);
+    }
+
+    static int get_num_threads() {
+        return num_threads;
+    }
+
     bool is_solvable() const;
 
     int get_cost(const State &state) const;
@@ -157,7 +157,8 @@ AbstractionBuilder::AbstractionBuilder(const plugins::Options &opts) :
     opts(opts), expensive_statistics(opts.get<bool>("expensive_statistics")),
     dump(opts.get<bool>("dump")),
     limit_seconds_total(opts.get<int>("limit_seconds_total")),
-    limit_memory_kb_total(opts.get<int>("limit_memory_kb")) {
+    limit_memory_kb_total(opts.get<int>("limit_memory_kb")),
+    num_threads(opts.get<int>("num_threads")) {
 }
 
 AbsBuilderAtomic::AbsBuilderAtomic(const plugins::Options &opts) :
@@ -299,6 +300,11 @@ void AbstractionBuilder::add_options_to_feature(plugins::Feature &feature) {
                             "limit the memory for building the merge and shrink abstractions"
                             "By default:  ",
                             "4000000");
+
+    feature.add_option<int>("num_threads",
+                            "number of threads used for the product construction and for shrinking "
+                            "(the work is distributed over labels)",
+                            "1");
 }
 
 
@@ -20,6 +20,7 @@ protected:
 
     const int limit_seconds_total;
     const int limit_memory_kb_total; //Limit of seconds for building the abstraction
+    const int num_threads;
 
 public:
     explicit AbstractionBuilder(const plugins::Options &opts);
@@ -35,6 +36,7 @@ public:
     // TODO adapt if OperatorCost::Zero is supported
     std::unique_ptr<LDSimulation>
     build_abstraction(OperatorCost cost_type, std::vector<std::unique_ptr<Abstraction>> &abstractions) const {
+        Abstraction::set_num_threads(num_threads);
         std::unique_ptr<LDSimulation> ldSim;
         build_abstraction(is_unit_cost_task(cost_type), cost_type, ldSim, abstractions);
         return ldSim;
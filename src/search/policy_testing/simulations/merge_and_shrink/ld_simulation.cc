@@ -286,6 +286,7 @@ void LDSimulation::complete_heuristic(MergeStrategy *merge_strategy, ShrinkStrat
             " time: " << t_mas() << "/" << limit_seconds << "s" <<
             " memory: " << utils::get_peak_memory_in_kb() << "/" << limit_memory_kb << " KB" << std::endl;
 
+        check_cancelled();
         remaining_abstractions--;
         std::pair<int, int> next_systems = merge_strategy->get_next(all_abstractions);
         int system_one = next_systems.first;
@@ -567,6 +568,7 @@ void LDSimulation::build_abstraction(MergeStrategy *merge_strategy, int limit_ab
             " time: " << t() << "/" << limit_seconds << "s" <<
             " memory: " << utils::get_peak_memory_in_kb() << "/" << limit_memory_kb << " KB" << std::endl;
 
+        check_cancelled();
         std::pair<int, int> next_systems = original_merge ? merge_strategy->get_next(all_abstractions) :
             merge_strategy->get_next(all_abstractions, limit_absstates_merge,
                                      min_limit_absstates_merge,
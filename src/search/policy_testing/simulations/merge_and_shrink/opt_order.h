@@ -6,7 +6,7 @@
 
 namespace simulations {
 class InfluenceGraph {
-    inline static utils::RandomNumberGenerator order_rng = utils::RandomNumberGenerator(2022);
+    inline static thread_local utils::RandomNumberGenerator order_rng = utils::RandomNumberGenerator(2022);
 
     std::vector<std::vector<long>> influence_graph;
 
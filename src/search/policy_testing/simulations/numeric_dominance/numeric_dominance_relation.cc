@@ -77,6 +77,29 @@ T NumericDominanceRelation<T>::q_dominates_value(const std::vector<int> &t, cons
     return total_value;
 }
 
+template<typename T>
+void NumericDominanceRelation<T>::get_abstract_state_ids(const State &t, int *ids) const {
+    for (std::size_t i = 0; i < simulations.size(); ++i) {
+        ids[i] = simulations[i]->get_abstract_state_id(t);
+    }
+}
+
+template<typename T>
+T NumericDominanceRelation<T>::q_dominates_value_by_ids(const int *t_ids, const int *s_ids) const {
+    T total_value = 0;
+    for (std::size_t i = 0; i < simulations.size(); ++i) {
+        if (t_ids[i] == -1 || s_ids[i] == -1) {
+            return MINUS_INFINITY;
+        }
+        T val = simulations[i]->q_simulates(t_ids[i], s_ids[i]);
+        if (val == MINUS_INFINITY) {
+            return MINUS_INFINITY;
+        }
+        total_value += val;
+    }
+    return total_value;
+}
+
 template<typename T>
 bool NumericDominanceRelation<T>::dominates(const State &t, const State &s, int g_diff) const {
     T total_value = 0;
@@ -52,6 +52,37 @@ public:
         return total_value;
     }
 
+    /// stores the abstract state id of t in every simulation in ids (-1 if t is pruned in the abstraction)
+    void get_abstract_state_ids(const State &t, int *ids) const {
+        for (std::size_t i = 0; i < simulations.size(); ++i) {
+            ids[i] = simulations[i]->get_abstract_state_id(t);
+        }
+    }
+
+    /// q_dominates_value for abstract state ids as computed by get_abstract_state_ids
+    [[nodiscard]] int q_dominates_value_by_ids(const int *t_ids, const int *s_ids) const {
+        int total_value = 0;
+        for (std::size_t i = 0; i < simulations.size(); ++i) {
+            if (t_ids[i] == -1 || s_ids[i] == -1) {
+                return MINUS_INFINITY;
+            }
+            int val = simulations[i]->q_simulates(t_ids[i], s_ids[i]);
+            if (val == MINUS_INFINITY) {
+                return MINUS_INFINITY;
+            }
+            total_value += val;
+        }
+        return total_value;
+    }
+
+    [[nodiscard]] int size() const {
+        return simulations.size();
+    }
+
+    const StrippedNumericSimulationRelation &operator[](int index) const {
+        return *(simulations[index]);
+    }
+
     [[nodiscard]] const StrippedNumericSimulationRelation &get_simulation_of_variable(int var) const {
         return *simulations[simulation_of_variable[var]];
     }
@@ -165,6 +196,7 @@ protected:
                 num_iterations++;
                 int remaining_to_compute = order_by_size.size();
                 for (int i: order_by_size) {
+                    check_cancelled();
                     int max_time = std::max(max_simulation_time,
                                             std::min(min_simulation_time,
                                                      1 + max_total_time / remaining_to_compute--));
@@ -252,6 +284,11 @@ public:
     T q_dominates_value(const State &t, const State &s) const;
     T q_dominates_value(const std::vector<int> &t, const std::vector<int> &s) const;
 
+    /// stores the abstract state id of t in every simulation in ids (-1 if t is pruned in the abstraction)
+    void get_abstract_state_ids(const State &t, int *ids) const;
+    /// q_dominates_value for abstract state ids as computed by get_abstract_state_ids
+    T q_dominates_value_by_ids(const int *t_ids, const int *s_ids) const;
+
     bool dominates_parent(const std::vector<int> &state, const std::vector<int> &parent, int action_cost) const;
 
     void init(const std::vector<Abstraction *> &abstractions);
@@ -9,24 +9,47 @@ NumericLabelRelation<T>::NumericLabelRelation(Labels *_labels, int num_labels_to
 
 template<typename T>
 bool NumericLabelRelation<T>::update(int lts_i, const LabelledTransitionSystem *lts,
-                                     const NumericSimulationRelation<T> &sim) {
+                                     const NumericSimulationRelation<T> &sim, NewlyInfinite &newly_infinite) {
+    // transitions of all label groups sorted by source state, so that the transitions of two label groups with the
+    // same source state can be matched in a single pass
+    const int num_groups = lts->get_num_label_groups();
+    std::vector<std::vector<TSTransition>> sorted_copies;
+    std::vector<const std::vector<TSTransition> *> transitions_of_group(num_groups);
+    for (LabelGroup lg(0); lg.group < num_groups; ++lg) {
+        const auto &transitions = lts->get_transitions_label_group(lg);
+        if (std::is_sorted(transitions.begin(), transitions.end())) {
+            transitions_of_group[lg.group] = &transitions;
+        } else {
+            sorted_copies.push_back(transitions);
+            std::sort(sorted_copies.back().begin(), sorted_copies.back().end());
+        }
+    }
+    for (int g = 0, copy = 0; g < num_groups; ++g) {
+        if (!transitions_of_group[g]) {
+            transitions_of_group[g] = &sorted_copies[copy++];
+        }
+    }
+
     bool changes = false;
-    for (LabelGroup lg2(0); lg2.group < lts->get_num_label_groups(); ++lg2) {
-        for (LabelGroup lg1(0); lg1.group < lts->get_num_label_groups(); ++lg1) {
+    for (LabelGroup lg2(0); lg2.group < num_groups; ++lg2) {
+        const std::vector<TSTransition> &transitions2 = *transitions_of_group[lg2.group];
+        for (LabelGroup lg1(0); lg1.group < num_groups; ++lg1) {
             if (lg1 != lg2 && may_simulate(lg1, lg2, lts_i)) {
                 T min_value = std::numeric_limits<int>::max();
-                //std::cout << "Check " << l1 << " " << l2 << std::endl;
-                //std::cout << "Num transitions: " << lts->get_transitions_label(l1).size()
-                //		    << " " << lts->get_transitions_label(l2).size() << std::endl;
                 //Check if it really simulates
                 //For each transition s--l2-->t, and every label l1 that dominates
                 //l2, exist s--l1-->t', t <= t'?
-
-                for (const auto &tr: lts->get_transitions_label_group(lg2)) {
+                const std::vector<TSTransition> &transitions1 = *transitions_of_group[lg1.group];
+                std::size_t first_with_src = 0;
+                for (const auto &tr: transitions2) {
+                    while (first_with_src < transitions1.size() && transitions1[first_with_src].src < tr.src) {
+                        ++first_with_src;
+                    }
                     T max_value = MINUS_INFINITY;
-                    //TODO: for(auto tr2 : lts->get_transitions_for_label_src(l1, tr.src)){
-                    for (const auto &tr2: lts->get_transitions_label_group(lg1)) {
-                        if (tr2.src == tr.src && sim.may_simulate(tr2.target, tr.target)) {
+                    for (std::size_t j = first_with_src; j < transitions1.size() && transitions1[j].src == tr.src;
+                         ++j) {
+                        const auto &tr2 = transitions1[j];
+                        if (sim.may_simulate(tr2.target, tr.target)) {
                             max_value = std::max(max_value, sim.q_simulates(tr2.target, tr.target));
                             if (max_value >= min_value) {
                                 break;     //Stop checking this tr
@@ -39,7 +62,7 @@ bool NumericLabelRelation<T>::update(int lts_i, const LabelledTransitionSystem *
                     }
                 }
 
-                changes |= set_lqrel(lg1, lg2, lts_i, lts, min_value);
+                changes |= set_lqrel(lg1, lg2, lts_i, min_value, newly_infinite);
                 assert(min_value != std::numeric_limits<int>::max());
             }
         }
@@ -48,7 +71,7 @@ bool NumericLabelRelation<T>::update(int lts_i, const LabelledTransitionSystem *
         T old_value = get_simulated_by_irrelevant(lg2, lts_i);
         if (old_value != T(MINUS_INFINITY)) {
             T min_value = std::numeric_limits<int>::max();
-            for (const auto &tr: lts->get_transitions_label_group(lg2)) {
+            for (const auto &tr: transitions2) {
                 min_value = std::min(min_value, sim.q_simulates(tr.src, tr.target));
                 if (min_value == MINUS_INFINITY) {
                     break;
@@ -58,7 +81,7 @@ bool NumericLabelRelation<T>::update(int lts_i, const LabelledTransitionSystem *
             assert(min_value != std::numeric_limits<int>::max());
 
             if (min_value < old_value) {
-                changes |= set_simulated_by_irrelevant(lg2, lts_i, lts, min_value);
+                changes |= set_simulated_by_irrelevant(lg2, lts_i, min_value, newly_infinite);
             }
         }
 
@@ -66,27 +89,60 @@ bool NumericLabelRelation<T>::update(int lts_i, const LabelledTransitionSystem *
         old_value = get_simulates_irrelevant(lg2, lts_i);
         if (old_value != MINUS_INFINITY) {
             T min_value = std::numeric_limits<int>::max();
-            for (int s = 0; s < lts->size(); s++) {
+            std::size_t j = 0;
+            for (int s = 0; s < lts->size() && min_value != MINUS_INFINITY; s++) {
                 T max_value = MINUS_INFINITY;
-                for (const auto &tr: lts->get_transitions_label_group(lg2)) {
-                    if (tr.src == s) {
+                for (; j < transitions2.size() && transitions2[j].src == s; ++j) {
+                    const auto &tr = transitions2[j];
+                    if (max_value <= min_value) {
                         max_value = std::max(max_value, sim.q_simulates(tr.target, tr.src));
-                        if (max_value > min_value) {
-                            break;
-                        }
                     }
                 }
                 min_value = std::min(min_value, max_value);
             }
             assert(min_value != std::numeric_limits<int>::max());
             if (min_value < old_value) {
-                changes |= set_simulates_irrelevant(lg2, lts_i, lts, min_value);
+                changes |= set_simulates_irrelevant(lg2, lts_i, min_value, newly_infinite);
             }
         }
     }
     return changes;
 }
 
+template<typename T>
+void NumericLabelRelation<T>::update_summaries(int lts_id, const LabelledTransitionSystem *lts,
+                                               const NewlyInfinite &newly_infinite) {
+    if (!dominates_in.empty()) {
+        for (const auto &[lgroup1, lgroup2] : newly_infinite.lqrel) {
+            for (int l1: lts->get_labels(lgroup1)) {
+                for (int l2: lts->get_labels(lgroup2)) {
+                    set_not_dominating_in(dominates_in[l1][l2], lts_id);
+                }
+            }
+        }
+    }
+    for (LabelGroup lgroup : newly_infinite.simulated_by_irrelevant) {
+        for (int l: lts->get_labels(lgroup)) {
+            set_not_dominating_in(dominated_by_noop_in[l], lts_id);
+            if (!dominates_in.empty()) {
+                for (int l1: irrelevant_labels_lts[lts_id]) {
+                    set_not_dominating_in(dominates_in[l1][l], lts_id);
+                }
+            }
+        }
+    }
+    for (LabelGroup lgroup : newly_infinite.simulates_irrelevant) {
+        for (int l: lts->get_labels(lgroup)) {
+            set_not_dominating_in(dominates_noop_in[l], lts_id);
+            if (!dominates_in.empty()) {
+                for (int l2: irrelevant_labels_lts[lts_id]) {
+                    set_not_dominating_in(dominates_in[l][l2], lts_id);
+                }
+            }
+        }
+    }
+}
+
 
 template<typename T>
 void NumericLabelRelation<T>::dump(const LabelledTransitionSystem *lts, int lts_id) const {
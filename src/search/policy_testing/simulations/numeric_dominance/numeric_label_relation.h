@@ -10,6 +10,7 @@
 #include "../merge_and_shrink/label.h"
 #include "../merge_and_shrink/labelled_transition_system.h"
 #include "int_epsilon.h"
+#include "../utils/utilities.h"
 
 namespace simulations {
 class LabelledTransitionSystem;
@@ -42,14 +43,40 @@ class NumericLabelRelation {
     std::vector<T> cost_of_label;
     std::vector<std::vector<LabelGroup>> group_of_label;     //position that label l takes on lts
     std::vector<std::vector<int>> irrelevant_labels_lts;
-    std::vector<std::vector<std::vector<T>>> lqrel;
+    // lqrel[lts] is the label group x label group matrix of lts stored row by row
+    std::vector<int> num_label_groups;
+    std::vector<std::vector<T>> lqrel;
     std::vector<std::vector<T>> simulated_by_irrelevant;
     std::vector<std::vector<T>> simulates_irrelevant;
 
+    // version of the simulation relation of each lts its entries have last been computed from
+    std::vector<long long> updated_with_relation_version;
+
+    /*
+     * Entries of one lts that dropped to MINUS_INFINITY during an update. The summaries dominates_in,
+     * dominates_noop_in and dominated_by_noop_in are shared by all ltss, so they are only adjusted after the
+     * (possibly parallel) updates of the individual ltss are done.
+     */
+    struct NewlyInfinite {
+        std::vector<std::pair<LabelGroup, LabelGroup>> lqrel;
+        std::vector<LabelGroup> simulated_by_irrelevant;
+        std::vector<LabelGroup> simulates_irrelevant;
+    };
+
     /* std::shared_ptr<TauLabelManager<T>> tau_labels; */
 
     bool update(int i, const LabelledTransitionSystem *lts,
-                const NumericSimulationRelation <T> &sim);
+                const NumericSimulationRelation <T> &sim, NewlyInfinite &newly_infinite);
+
+    void update_summaries(int lts_id, const LabelledTransitionSystem *lts, const NewlyInfinite &newly_infinite);
+
+    static inline void set_not_dominating_in(int &dominates_in_entry, int lts_id) {
+        if (dominates_in_entry == DOMINATES_IN_ALL) {
+            dominates_in_entry = lts_id;
+        } else if (dominates_in_entry != lts_id) {
+            dominates_in_entry = DOMINATES_IN_NONE;
+        }
+    }
 
     inline T get_lqrel(LabelGroup lgroup1, LabelGroup lgroup2, int lts) const {
         int pos1 = lgroup1.group;
@@ -59,7 +86,7 @@ class NumericLabelRelation {
         //int pos2 = position_of_label[lts][l2];
         if (pos1 >= 0) {
             if (pos2 >= 0) {
-                return lqrel[lts][pos1][pos2];
+                return lqrel[lts][pos1 * num_label_groups[lts] + pos2];
             } else {
                 return simulates_irrelevant[lts][pos1];
             }
@@ -76,35 +103,23 @@ class NumericLabelRelation {
         return get_lqrel(group_of_label[lts][l1], group_of_label[lts][l2], lts);
     }
 
-    inline bool set_lqrel(LabelGroup lgroup1, LabelGroup lgroup2, int lts_id,
-                          const LabelledTransitionSystem *lts, T value) {
+    inline bool set_lqrel(LabelGroup lgroup1, LabelGroup lgroup2, int lts_id, T value,
+                          NewlyInfinite &newly_infinite) {
         assert(value != MINUS_INFINITY + 1);
-        /* assert(dominates_in.empty() ||
-           dominates_in[l1][l2] == DOMINATES_IN_ALL || dominates_in[l1][l2] != lts_id); */
         /* int pos1 = position_of_label[lts_id][l1]; */
         /* int pos2 = position_of_label[lts_id][l2]; */
 
         assert(lgroup1.group >= 0 && lgroup2.group >= 0);
-        const unsigned int pos1 = lgroup1.group;
-        const unsigned int pos2 = lgroup2.group;
-
         assert(lts_id >= 0 && lts_id < lqrel.size());
-        assert(pos1 < lqrel[lts_id].size());
-        assert(pos2 < lqrel[lts_id][pos1].size());
-
-        assert(value <= lqrel[lts_id][pos1][pos2]);
-        if (value < lqrel[lts_id][pos1][pos2]) {
-            lqrel[lts_id][pos1][pos2] = value;
-            if (value == MINUS_INFINITY && !dominates_in.empty()) {
-                for (int l1: lts->get_labels(lgroup1)) {
-                    for (int l2: lts->get_labels(lgroup2)) {
-                        if (dominates_in[l1][l2] == DOMINATES_IN_ALL) {
-                            dominates_in[l1][l2] = lts_id;
-                        } else if (dominates_in[l1][l2] != lts_id) {
-                            dominates_in[l1][l2] = DOMINATES_IN_NONE;
-                        }
-                    }
-                }
+        assert(lgroup1.group < num_label_groups[lts_id]);
+        assert(lgroup2.group < num_label_groups[lts_id]);
+        T &entry = lqrel[lts_id][lgroup1.group * num_label_groups[lts_id] + lgroup2.group];
+
+        assert(value <= entry);
+        if (value < entry) {
+            entry = value;
+            if (value == MINUS_INFINITY) {
+                newly_infinite.lqrel.emplace_back(lgroup1, lgroup2);
             }
             return true;
         }
@@ -127,9 +142,8 @@ class NumericLabelRelation {
         }
     }
 
-    inline bool set_simulated_by_irrelevant(LabelGroup lgroup, int lts_id,
-                                            const LabelledTransitionSystem *lts,
-                                            T value) {
+    inline bool set_simulated_by_irrelevant(LabelGroup lgroup, int lts_id, T value,
+                                            NewlyInfinite &newly_infinite) {
         //Returns if there were changes in dominated_by_noop_in
         //int pos = position_of_label[lts_id][l];
         int pos = lgroup.group;
@@ -140,22 +154,7 @@ class NumericLabelRelation {
         if (value < simulated_by_irrelevant[lts_id][pos]) {
             simulated_by_irrelevant[lts_id][pos] = value;
             if (value == MINUS_INFINITY) {
-                for (int l: lts->get_labels(lgroup)) {
-                    if (dominated_by_noop_in[l] == DOMINATES_IN_ALL) {
-                        dominated_by_noop_in[l] = lts_id;
-                    } else if (dominated_by_noop_in[l] != lts_id) {
-                        dominated_by_noop_in[l] = DOMINATES_IN_NONE;
-                    }
-                    if (!dominates_in.empty()) {
-                        for (int l1: irrelevant_labels_lts[lts_id]) {
-                            if (dominates_in[l1][l] == DOMINATES_IN_ALL) {
-                                dominates_in[l1][l] = lts_id;
-                            } else if (dominates_in[l1][l] != lts_id) {
-                                dominates_in[l1][l] = DOMINATES_IN_NONE;
-                            }
-                        }
-                    }
-                }
+                newly_infinite.simulated_by_irrelevant.push_back(lgroup);
             }
             return true;
         }
@@ -172,9 +171,8 @@ class NumericLabelRelation {
     }
 
 
-    inline bool set_simulates_irrelevant(LabelGroup lgroup, int lts_id,
-                                         const LabelledTransitionSystem *lts,
-                                         T value) {
+    inline bool set_simulates_irrelevant(LabelGroup lgroup, int lts_id, T value,
+                                         NewlyInfinite &newly_infinite) {
         assert(value != MINUS_INFINITY + 1);
 
         int pos = lgroup.group;
@@ -184,24 +182,8 @@ class NumericLabelRelation {
         assert(value <= simulates_irrelevant[lts_id][pos]);
         if (value < simulates_irrelevant[lts_id][pos]) {
             simulates_irrelevant[lts_id][pos] = value;
-
             if (value == MINUS_INFINITY) {
-                for (int l: lts->get_labels(lgroup)) {
-                    if (dominates_noop_in[l] == DOMINATES_IN_ALL) {
-                        dominates_noop_in[l] = lts_id;
-                    } else if (dominates_noop_in[l] != lts_id) {
-                        dominates_noop_in[l] = DOMINATES_IN_NONE;
-                    }
-                    if (!dominates_in.empty()) {
-                        for (int l2: irrelevant_labels_lts[lts_id]) {
-                            if (dominates_in[l][l2] == DOMINATES_IN_ALL) {
-                                dominates_in[l][l2] = lts_id;
-                            } else if (dominates_in[l][l2] != lts_id) {
-                                dominates_in[l][l2] = DOMINATES_IN_NONE;
-                            }
-                        }
-                    }
-                }
+                newly_infinite.simulates_irrelevant.push_back(lgroup);
             }
             return true;
         }
@@ -230,7 +212,7 @@ public:
 
         std::vector<T>().swap(cost_of_label);
         std::vector<std::vector<LabelGroup>>().swap(group_of_label);
-        std::vector<std::vector<std::vector<T>>>().swap(lqrel);
+        std::vector<std::vector<T>>().swap(lqrel);
         std::vector<std::vector<T>>().swap(simulates_irrelevant);
         std::vector<std::vector<T>>().swap(simulated_by_irrelevant);
 
@@ -238,7 +220,9 @@ public:
         group_of_label.resize(lts.size());
         simulates_irrelevant.resize(lts.size());
         simulated_by_irrelevant.resize(lts.size());
+        num_label_groups.assign(lts.size(), 0);
         lqrel.resize(lts.size());
+        updated_with_relation_version.assign(lts.size(), -1);
 
         cost_of_label.resize(num_labels);
         for (int l = 0; l < num_labels; l++) {
@@ -255,11 +239,11 @@ public:
 
             simulates_irrelevant[i].resize(num_label_groups, std::numeric_limits<int>::max());
             simulated_by_irrelevant[i].resize(num_label_groups, std::numeric_limits<int>::max());
-            lqrel[i].resize(num_label_groups);
+            this->num_label_groups[i] = num_label_groups;
+            lqrel[i].resize(num_label_groups * num_label_groups, std::numeric_limits<int>::max());
 
             for (int j = 0; j < num_label_groups; j++) {
-                lqrel[i][j].resize(num_label_groups, std::numeric_limits<int>::max());
-                lqrel[i][j][j] = 0;
+                lqrel[i][j * num_label_groups + j] = 0;
             }
         }
 
@@ -279,18 +263,27 @@ public:
         std::cout << "Update label dominance: " << num_labels
                   << " labels " << lts.size() << " systems.\n";
 
-        for (int i = 0; i < num_ltss; ++i) {
-            update(i, lts[i], sim[i]);
-        }
+        update(lts, sim);
     }
 
 
     template<typename NDR>
     bool update(const std::vector<LabelledTransitionSystem *> &lts, const NDR &sim) {
-        bool changes = false;
+        // the entries of lts i only depend on its own simulation relation, so they only need to be recomputed
+        // if that one changed, and the ltss can be processed independently
+        std::vector<NewlyInfinite> newly_infinite(lts.size());
+        std::vector<char> lts_changed(lts.size(), false);
+        parallel_for(lts.size(), Abstraction::get_num_threads(), [&](int i) {
+                         if (sim[i].get_relation_version() != updated_with_relation_version[i]) {
+                             updated_with_relation_version[i] = sim[i].get_relation_version();
+                             lts_changed[i] = update(i, lts[i], sim[i], newly_infinite[i]);
+                         }
+                     });
 
+        bool changes = false;
         for (unsigned int i = 0; i < lts.size(); ++i) {
-            changes |= update(i, lts[i], sim[i]);
+            update_summaries(i, lts[i], newly_infinite[i]);
+            changes |= lts_changed[i];
         }
 
         return changes;
@@ -41,6 +41,8 @@ void NumericSimulationRelation<T>::init_goal_respecting() {
             relation[s][t] = goal_distances[t] - goal_distances[s];
         }
     }
+    // the entries are written directly, so a label relation computed before has to be updated
+    ++relation_version;
     tau_distances_id = 0;
 }
 
@@ -69,6 +71,8 @@ void NumericSimulationRelation<IntEpsilon>::init_goal_respecting() {
             // }
         }
     }
+    // the entries are written directly, so a label relation computed before has to be updated
+    ++relation_version;
     tau_distances_id = 0;
 }
 
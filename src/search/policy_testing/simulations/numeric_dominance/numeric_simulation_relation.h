@@ -19,6 +19,8 @@ class StrippedNumericSimulationRelation {
     std::unique_ptr<StrippedAbstraction> abs;
     std::vector<std::vector<int>> relation;
 
+public:
+
     [[nodiscard]] inline int q_simulates(unsigned int s, unsigned int t) const {
         assert(s < relation.size());
         assert(t < relation[s].size());
@@ -26,8 +28,6 @@ class StrippedNumericSimulationRelation {
         return relation[s][t];
     }
 
-public:
-
     StrippedNumericSimulationRelation() = default;
     StrippedNumericSimulationRelation(std::unique_ptr<StrippedAbstraction> &&abs,
                                       std::vector<std::vector<int>> relation) :
@@ -51,6 +51,18 @@ public:
         return q_simulates(tid, sid);
     }
 
+    [[nodiscard]] int get_abstract_state_id(const State &t) const {
+        return abs->get_abstract_state(t);
+    }
+
+    [[nodiscard]] unsigned int num_abstract_states() const {
+        return relation.size();
+    }
+
+    [[nodiscard]] bool may_simulate(unsigned int s, unsigned int t) const {
+        return q_simulates(s, t) > MINUS_INFINITY;
+    }
+
     [[nodiscard]] int atomic_q_simulates(int t, int s) const {
         int tid = abs->get_atomic_abstract_state(t);
         int sid = abs->get_atomic_abstract_state(s);
@@ -100,6 +112,8 @@ protected:
     int tau_distances_id{};
 
     std::vector<std::vector<T>> relation;
+    // incremented whenever an entry of relation is changed by update_value
+    long long relation_version = 0;
 
     T max_relation_value;
 
@@ -159,6 +173,10 @@ public:
         return relation[s][t] >= 0;
     }
 
+    [[nodiscard]] unsigned int num_abstract_states() const {
+        return relation.size();
+    }
+
     [[nodiscard]] inline bool may_simulate(unsigned int s, unsigned int t) const {
         assert(s < relation.size());
         assert(t < relation[s].size());
@@ -195,7 +213,14 @@ public:
      */
 
     inline void update_value(int s, int t, T value) {
-        relation[s][t] = value;
+        if (relation[s][t] != value) {
+            relation[s][t] = value;
+            ++relation_version;
+        }
+    }
+
+    [[nodiscard]] long long get_relation_version() const {
+        return relation_version;
     }
 
     /*
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <utility>
 #include <set>
 
@@ -65,11 +66,15 @@ struct SimulationsManager {
     inline static std::vector<std::vector<Prevail>> operator_prevails;
     inline static std::vector<std::vector<PrePost>> operator_preposts;
     // simulate hack used in merge and shrink
-    inline static std::vector<bool> is_dead_operator;
+    // (thread-local so that abstractions can be built in a background thread, see set_dead_operators)
+    inline static thread_local std::vector<bool> is_dead_operator;
     // simulate hack used in sym abstraction
     inline static std::vector<bool> op_marker_1;
     inline static std::vector<bool> op_marker_2;
 
+    // set by the owner of a background computation to stop it (see check_cancelled)
+    inline static thread_local const std::atomic<bool> *cancellation_flag = nullptr;
+
     inline static bool initialized = false;
     inline static std::vector<std::function<void(void)>> initialization_functions;
 
@@ -212,6 +217,15 @@ inline static void set_dead(OperatorID op) {
     set_dead(op.get_index());
 }
 
+/**
+ * Initializes the dead operators of the calling thread, e.g., with a copy of those of the thread that set the
+ * simulation task.
+ */
+inline static void set_dead_operators(std::vector<bool> dead_operators) {
+    assert(SimulationsManager::initialized);
+    SimulationsManager::is_dead_operator = std::move(dead_operators);
+}
+
 inline static bool is_dead(int op) {
     assert(SimulationsManager::initialized);
     return SimulationsManager::is_dead_operator[op];
@@ -277,5 +291,32 @@ inline static void get_vars(int op_id, std::set<int> &pre_vars, std::set<int> &e
     }
 }
 
-inline static utils::RandomNumberGenerator simulations_rng = utils::RandomNumberGenerator(2022);
+/**
+ * Thrown by check_cancelled to abort the computation of abstractions and dominance relations of the calling thread.
+ */
+class ComputationCancelled : public std::exception {
+public:
+    [[nodiscard]] const char *what() const noexcept override {
+        return "simulation computation cancelled";
+    }
+};
+
+/**
+ * Makes check_cancelled in the calling thread throw once flag is set (nullptr: never).
+ */
+inline static void set_cancellation_flag(const std::atomic<bool> *flag) {
+    SimulationsManager::cancellation_flag = flag;
+}
+
+/**
+ * Called regularly by long computations, throws ComputationCancelled if the computation should stop.
+ */
+inline static void check_cancelled() {
+    if (SimulationsManager::cancellation_flag && SimulationsManager::cancellation_flag->load(std::memory_order_relaxed)) {
+        throw ComputationCancelled();
+    }
+}
+
+// thread-local so that a background dominance computation does not interfere with the testing thread
+inline static thread_local utils::RandomNumberGenerator simulations_rng = utils::RandomNumberGenerator(2022);
 } // simulations
@@ -6,6 +6,7 @@
 #include <vector>
 #include <algorithm>
 #include <iostream>
+#include <thread>
 
 namespace simulations {
 template<class T>
@@ -30,6 +31,42 @@ size_t hash_number_sequence(const Sequence &data, size_t length) {
     return hash_value;
 }
 
+/**
+ * Calls body(i) for every i in [0, n), distributing the indices round-robin over num_threads threads.
+ * body(i) must only modify data associated with index i.
+ */
+template<typename F>
+void parallel_for(int n, int num_threads, F body) {
+    num_threads = std::min(num_threads, n);
+    if (num_threads <= 1) {
+        for (int i = 0; i < n; ++i) {
+            body(i);
+        }
+        return;
+    }
+    std::vector<std::thread> workers;
+    workers.reserve(num_threads);
+    for (int t = 0; t < num_threads; ++t) {
+        workers.emplace_back([&body, n, num_threads, t]() {
+                                 for (int i = t; i < n; i += num_threads) {
+                                     body(i);
+                                 }
+                             });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * Sorts values and removes duplicates in one bulk step.
+ */
+template<class T>
+void sort_unique(std::vector<T> &values) {
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+}
+
 template<typename T, typename F>
 void erase_if(T &container, F lambda) {
     container.erase(std::remove_if(container.begin(), container.end(), lambda), container.end());
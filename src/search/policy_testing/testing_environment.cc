@@ -31,4 +31,14 @@ StateRegistry *
 TestingEnvironment::get_state_registry() const {
     return state_registry_;
 }
+
+FuzzingStateTable *
+TestingEnvironment::get_fuzzing_state_table() const {
+    return fuzzing_state_table_;
+}
+
+void
+TestingEnvironment::set_fuzzing_state_table(FuzzingStateTable *table) {
+    fuzzing_state_table_ = table;
+}
 } // namespace policy_testing
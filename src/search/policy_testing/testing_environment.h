@@ -14,6 +14,8 @@ class SuccessorGenerator;
 }
 
 namespace policy_testing {
+class FuzzingStateTable;
+
 /**
  * General environment shared across the various components of a testing
  * run.
@@ -32,10 +34,16 @@ public:
     [[nodiscard]] successor_generator::SuccessorGenerator &get_successor_generator() const;
     [[nodiscard]] StateRegistry *get_state_registry() const;
 
+    /**
+     * Per-state metadata of the fuzzing engine; nullptr if the engine does not maintain one.
+     **/
+    [[nodiscard]] FuzzingStateTable *get_fuzzing_state_table() const;
+    void set_fuzzing_state_table(FuzzingStateTable *table);
 
 private:
     std::shared_ptr<AbstractTask> task_;
     StateRegistry *state_registry_;
     TaskProxy task_proxy_;
+    FuzzingStateTable *fuzzing_state_table_ = nullptr;
 };
 } // namespace policy_testing
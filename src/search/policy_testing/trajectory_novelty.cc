@@ -0,0 +1,47 @@
+#include "trajectory_novelty.h"
+
+#include <iostream>
+
+namespace policy_testing {
+TrajectoryNovelty::TrajectoryNovelty(unsigned arity, const std::shared_ptr<AbstractTask> &task)
+    : fact_sets(arity, task),
+      known(false) {
+}
+
+bool TrajectoryNovelty::is_known(const State &state) {
+    bool &state_known = known[state];
+    if (!state_known && fact_sets.compute_novelty(state) == 0) {
+        state_known = true;
+    }
+    return state_known;
+}
+
+void TrajectoryNovelty::insert_path(const std::vector<State> &path) {
+    ++num_recorded_paths;
+    for (const State &state : path) {
+        // all fact sets of known states are recorded already
+        if (!known[state]) {
+            fact_sets.insert(state);
+            known[state] = true;
+            ++num_recorded_states;
+        }
+    }
+}
+
+int TrajectoryNovelty::novel_path_prefix_length(const std::vector<State> &path) {
+    int length = 0;
+    for (const State &state : path) {
+        if (is_known(state)) {
+            break;
+        }
+        ++length;
+    }
+    return length;
+}
+
+void TrajectoryNovelty::print_statistics() const {
+    std::cout << "Recorded trajectories: " << num_recorded_paths << std::endl;
+    std::cout << "Recorded trajectory states: " << num_recorded_states << std::endl;
+    fact_sets.print_statistics();
+}
+} // namespace policy_testing
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "novelty_store.h"
+
+#include "../per_state_information.h"
+
+#include <memory>
+#include <vector>
+
+namespace policy_testing {
+/**
+ * Tracks the fact sets of all states on recorded policy trajectories. States are scored by the number of leading
+ * states of their policy path that contain a fact set not seen on any recorded trajectory, i.e., by how long their
+ * trajectory stays novel before it joins the recorded ones.
+ */
+class TrajectoryNovelty {
+public:
+    TrajectoryNovelty(unsigned arity, const std::shared_ptr<AbstractTask> &task);
+
+    /**
+     * Records the fact sets of all states on the path that have not been recorded before.
+     */
+    void insert_path(const std::vector<State> &path);
+
+    /**
+     * @return the number of leading states of path with a fact set not seen on any recorded trajectory.
+     */
+    int novel_path_prefix_length(const std::vector<State> &path);
+
+    void print_statistics() const;
+
+private:
+    NoveltyStore fact_sets;
+    // states without novel fact set, this never changes once it holds as recorded fact sets are never removed
+    PerStateInformation<bool> known;
+    unsigned long long num_recorded_states = 0;
+    unsigned long long num_recorded_paths = 0;
+
+    bool is_known(const State &state);
+};
+} // namespace policy_testing
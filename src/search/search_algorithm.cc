@@ -39,14 +39,19 @@ static successor_generator::SuccessorGenerator &get_successor_generator(
     return successor_generator;
 }
 
-SearchAlgorithm::SearchAlgorithm(const plugins::Options &opts)
+SearchAlgorithm::SearchAlgorithm(
+    const plugins::Options &opts, bool concurrent_state_registry)
     : description(opts.get_unparsed_config()),
       status(IN_PROGRESS),
       solution_found(false),
       task(opts.contains("transform") ? opts.get<shared_ptr<AbstractTask>>("transform") : tasks::g_root_task),
       task_proxy(*task),
       log(utils::get_log_from_options(opts)),
-      state_registry(task_proxy),
+      state_registry(task_proxy, concurrent_state_registry,
+                     opts.get<bool>("incremental_state_hashing", false) ?
+                     StateHashing::INCREMENTAL : StateHashing::FULL,
+                     opts.get<StateStorage>("state_storage", StateStorage::PACKED),
+                     opts.get<int>("compressed_state_leaf_size", 2)),
       successor_generator(get_successor_generator(task_proxy, log)),
       search_space(state_registry, log),
       statistics(log),
@@ -157,6 +162,24 @@ void SearchAlgorithm::add_options_to_feature(plugins::Feature &feature) {
         "transform",
         "Optional task transformation for the search algorithm.",
         plugins::ArgumentInfo::NO_DEFAULT);
+    feature.add_option<bool>(
+        "incremental_state_hashing",
+        "derive the hash values of successor states from the hash value of "
+        "their predecessor and the changed facts (Zobrist hashing) instead of "
+        "hashing the complete state data. This is faster for tasks with many "
+        "variables and costs 4 bytes of memory per state.",
+        "false");
+    feature.add_option<StateStorage>(
+        "state_storage",
+        "how the state registry stores the registered states",
+        "packed");
+    feature.add_option<int>(
+        "compressed_state_leaf_size",
+        "number of packed bins per leaf of the compression trees with "
+        "state_storage=tree_compressed. Larger leaves make storing and looking "
+        "up states faster but compress less.",
+        "2",
+        plugins::Bounds("1", "infinity"));
     utils::add_log_options_to_feature(feature);
 }
 
@@ -200,6 +223,16 @@ public:
 }
 _category_plugin;
 
+static plugins::TypedEnumPlugin<StateStorage> _enum_plugin({
+    {"packed", "store the packed data of every state in place"},
+    {"tree_compressed",
+     "store states with tree compression: states that differ in few "
+     "variables share most of their storage. This needs much less memory "
+     "than packed storage for large searches, but states have to be "
+     "decompressed whenever they are looked up. Incremental state hashing "
+     "has no effect with this storage."}
+});
+
 void collect_preferred_operators(
     EvaluationContext &eval_context,
     Evaluator *preferred_operator_evaluator,
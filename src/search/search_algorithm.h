@@ -62,7 +62,12 @@ protected:
     bool check_goal_and_set_plan(const State &state);
     int get_adjusted_cost(const OperatorProxy &op) const;
 public:
-    SearchAlgorithm(const plugins::Options &opts);
+    /*
+      Search algorithms that let several threads work on the state registry
+      at the same time must ask for a concurrent registry.
+    */
+    explicit SearchAlgorithm(const plugins::Options &opts,
+                             bool concurrent_state_registry = false);
     virtual ~SearchAlgorithm();
     virtual void print_statistics() const = 0;
     virtual void save_plan_if_necessary();
@@ -0,0 +1,642 @@
+#include "external_astar_search.h"
+
+#include "../evaluation_context.h"
+#include "../evaluator.h"
+
+#include "../plugins/plugin.h"
+#include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <filesystem>
+#include <limits>
+#include <numeric>
+#include <queue>
+
+using namespace std;
+
+namespace external_astar_search {
+// Number of records expanded in one call of step().
+static const int EXPANSIONS_PER_STEP = 100;
+// Number of expansions after which the batch registry is replaced.
+static const int MAX_BATCH_SIZE = 1000;
+// Maximum number of sorted runs that are merged at once.
+static const size_t MAX_MERGED_FILES = 64;
+// Number of records a reader loads from disk at once.
+static const int READ_BUFFER_SIZE = 1024;
+static const PackedStateBin NO_OPERATOR = numeric_limits<PackedStateBin>::max();
+
+static int instance_count = 0;
+
+static void exit_with_file_error(const string &action, const string &path) {
+    cerr << "external_astar: could not " << action << " " << path << endl;
+    utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+}
+
+static bool state_less(const PackedStateBin *lhs, const PackedStateBin *rhs,
+                       int num_bins) {
+    return lexicographical_compare(lhs, lhs + num_bins, rhs, rhs + num_bins);
+}
+
+static bool state_equal(const PackedStateBin *lhs, const PackedStateBin *rhs,
+                        int num_bins) {
+    return equal(lhs, lhs + num_bins, rhs);
+}
+
+/*
+  Reads the records of a file sequentially with a buffer of
+  READ_BUFFER_SIZE records.
+*/
+class RecordReader {
+    ifstream file;
+    const int record_size;
+    vector<PackedStateBin> buffer;
+    int num_buffered;
+    int position;
+public:
+    const bool is_closed;
+
+    RecordReader(const string &path, int record_size, bool is_closed)
+        : file(path, ios::binary),
+          record_size(record_size),
+          buffer(READ_BUFFER_SIZE * record_size),
+          num_buffered(0),
+          position(0),
+          is_closed(is_closed) {
+        if (!file) {
+            exit_with_file_error("open", path);
+        }
+        advance();
+    }
+
+    bool exhausted() const {
+        return position >= num_buffered;
+    }
+
+    const PackedStateBin *get_record() const {
+        assert(!exhausted());
+        return &buffer[position * record_size];
+    }
+
+    void advance() {
+        ++position;
+        if (position >= num_buffered) {
+            file.read(reinterpret_cast<char *>(buffer.data()),
+                      buffer.size() * sizeof(PackedStateBin));
+            num_buffered = file.gcount() / (record_size * sizeof(PackedStateBin));
+            position = 0;
+        }
+    }
+};
+
+ExternalAStarSearch::ExternalAStarSearch(const plugins::Options &opts)
+    : SearchAlgorithm(opts),
+      evaluator(opts.get<shared_ptr<Evaluator>>("eval")),
+      directory_option(opts.get<string>("directory")),
+      max_sorted_records(opts.get<int>("max_sorted_records")),
+      state_packer(task_properties::g_state_packers[task_proxy]),
+      num_bins(state_packer.get_num_bins()),
+      record_size(2 * num_bins + 3),
+      next_file_id(0),
+      num_buffered_records(0),
+      records_left_to_expand(0),
+      current_g(-1),
+      current_h(-1),
+      batch_size(0),
+      num_duplicates(0),
+      num_records_written(0),
+      num_sorted_runs(0),
+      num_compactions(0) {
+    set<Evaluator *> path_dependent_evaluators;
+    evaluator->get_path_dependent_evaluators(path_dependent_evaluators);
+    if (!path_dependent_evaluators.empty()) {
+        cerr << "external_astar does not support path-dependent evaluators."
+             << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+}
+
+ExternalAStarSearch::~ExternalAStarSearch() {
+    expansion_file.close();
+    if (!directory.empty()) {
+        error_code error;
+        filesystem::remove_all(directory, error);
+    }
+}
+
+string ExternalAStarSearch::get_new_file_path(const string &prefix) {
+    return directory + "/" + prefix + "_" + to_string(next_file_id++);
+}
+
+State ExternalAStarSearch::create_state(const PackedStateBin *bins) {
+    vector<int> values(task_proxy.get_variables().size());
+    for (size_t var = 0; var < values.size(); ++var) {
+        values[var] = state_packer.get(bins, var);
+    }
+    return batch_registry->insert_state(values);
+}
+
+static string get_bucket_path(const string &directory, int g, int h) {
+    return directory + "/bucket_" + to_string(g) + "_" + to_string(h);
+}
+
+void ExternalAStarSearch::add_record(int g, int h, const Record &record) {
+    vector<PackedStateBin> &buffer = write_buffers[make_pair(g, h)];
+    buffer.insert(buffer.end(), record.begin(), record.end());
+    open_buckets.emplace(g + h, -g);
+    if (++num_buffered_records >= max_sorted_records) {
+        flush_write_buffers();
+    }
+}
+
+void ExternalAStarSearch::flush_write_buffer(int g, int h) {
+    auto it = write_buffers.find(make_pair(g, h));
+    if (it == write_buffers.end()) {
+        return;
+    }
+    string path = get_bucket_path(directory, g, h);
+    ofstream file(path, ios::binary | ios::app);
+    const vector<PackedStateBin> &buffer = it->second;
+    file.write(reinterpret_cast<const char *>(buffer.data()),
+               buffer.size() * sizeof(PackedStateBin));
+    if (!file) {
+        exit_with_file_error("write", path);
+    }
+    int num_records = buffer.size() / record_size;
+    num_records_written += num_records;
+    num_buffered_records -= num_records;
+    write_buffers.erase(it);
+}
+
+void ExternalAStarSearch::flush_write_buffers() {
+    while (!write_buffers.empty()) {
+        auto [g, h] = write_buffers.begin()->first;
+        flush_write_buffer(g, h);
+    }
+    assert(num_buffered_records == 0);
+}
+
+/*
+  Merges sorted files of records. Calls handle_group for each state with the
+  indices of the readers whose current record has this state.
+*/
+template<typename HandleGroup>
+static void merge_sorted_files(
+    vector<unique_ptr<RecordReader>> &readers, int num_bins,
+    const HandleGroup &handle_group) {
+    auto greater_state = [&](int lhs, int rhs) {
+            return state_less(readers[rhs]->get_record(),
+                              readers[lhs]->get_record(), num_bins);
+        };
+    priority_queue<int, vector<int>, decltype(greater_state)> queue(greater_state);
+    for (size_t i = 0; i < readers.size(); ++i) {
+        if (!readers[i]->exhausted()) {
+            queue.push(i);
+        }
+    }
+    vector<int> equal_readers;
+    while (!queue.empty()) {
+        equal_readers.clear();
+        equal_readers.push_back(queue.top());
+        queue.pop();
+        while (!queue.empty() &&
+               state_equal(readers[queue.top()]->get_record(),
+                           readers[equal_readers[0]]->get_record(), num_bins)) {
+            equal_readers.push_back(queue.top());
+            queue.pop();
+        }
+        handle_group(equal_readers);
+        for (int reader : equal_readers) {
+            readers[reader]->advance();
+            if (!readers[reader]->exhausted()) {
+                queue.push(reader);
+            }
+        }
+    }
+}
+
+/*
+  Splits the bucket file into runs of at most max_sorted_records records,
+  each sorted by state and without duplicates, and deletes the bucket file.
+  Returns at most MAX_MERGED_FILES runs.
+*/
+vector<string> ExternalAStarSearch::sort_bucket(const string &bucket_path) {
+    vector<string> run_paths;
+    ifstream bucket_file(bucket_path, ios::binary);
+    if (!bucket_file) {
+        exit_with_file_error("open", bucket_path);
+    }
+    size_t record_bytes = record_size * sizeof(PackedStateBin);
+    size_t num_bucket_records = filesystem::file_size(bucket_path) / record_bytes;
+    vector<PackedStateBin> records(
+        min<size_t>(max_sorted_records, num_bucket_records) * record_size);
+    vector<int> order;
+    while (true) {
+        bucket_file.read(reinterpret_cast<char *>(records.data()),
+                         records.size() * sizeof(PackedStateBin));
+        int num_records = bucket_file.gcount() / record_bytes;
+        if (num_records == 0) {
+            break;
+        }
+        auto get_state = [&](int index) {
+                return &records[static_cast<size_t>(index) * record_size];
+            };
+        order.resize(num_records);
+        iota(order.begin(), order.end(), 0);
+        stable_sort(order.begin(), order.end(), [&](int lhs, int rhs) {
+                        return state_less(get_state(lhs), get_state(rhs), num_bins);
+                    });
+        string run_path = get_new_file_path("run");
+        ofstream run_file(run_path, ios::binary);
+        for (int i = 0; i < num_records; ++i) {
+            if (i > 0 && state_equal(get_state(order[i - 1]), get_state(order[i]), num_bins)) {
+                ++num_duplicates;
+                continue;
+            }
+            run_file.write(reinterpret_cast<const char *>(get_state(order[i])),
+                           record_bytes);
+        }
+        if (!run_file) {
+            exit_with_file_error("write", run_path);
+        }
+        run_paths.push_back(run_path);
+        ++num_sorted_runs;
+    }
+    bucket_file.close();
+    filesystem::remove(bucket_path);
+
+    // Merge the runs in several passes if there are too many to open at once.
+    while (run_paths.size() > MAX_MERGED_FILES) {
+        vector<string> merged_run_paths;
+        for (size_t begin = 0; begin < run_paths.size(); begin += MAX_MERGED_FILES) {
+            size_t end = min(begin + MAX_MERGED_FILES, run_paths.size());
+            vector<unique_ptr<RecordReader>> readers;
+            for (size_t i = begin; i < end; ++i) {
+                readers.push_back(make_unique<RecordReader>(run_paths[i], record_size, false));
+            }
+            string merged_run_path = get_new_file_path("run");
+            ofstream merged_run_file(merged_run_path, ios::binary);
+            merge_sorted_files(
+                readers, num_bins, [&](const vector<int> &equal_readers) {
+                    num_duplicates += equal_readers.size() - 1;
+                    merged_run_file.write(
+                        reinterpret_cast<const char *>(
+                            readers[equal_readers[0]]->get_record()),
+                        record_bytes);
+                });
+            if (!merged_run_file) {
+                exit_with_file_error("write", merged_run_path);
+            }
+            readers.clear();
+            for (size_t i = begin; i < end; ++i) {
+                filesystem::remove(run_paths[i]);
+            }
+            merged_run_paths.push_back(merged_run_path);
+        }
+        run_paths.swap(merged_run_paths);
+    }
+    return run_paths;
+}
+
+/*
+  Merges the sorted runs of the bucket with the closed files of the same
+  h-value and writes the records of new states to a new closed file.
+*/
+ClosedFile ExternalAStarSearch::merge_bucket(int g, int h) {
+    flush_write_buffer(g, h);
+    vector<string> run_paths = sort_bucket(get_bucket_path(directory, g, h));
+
+    vector<unique_ptr<RecordReader>> readers;
+    for (const string &run_path : run_paths) {
+        readers.push_back(make_unique<RecordReader>(run_path, record_size, false));
+    }
+    for (const ClosedFile &closed_file : closed_files[h]) {
+        readers.push_back(make_unique<RecordReader>(closed_file.path, record_size, true));
+    }
+
+    ClosedFile closed_file{get_new_file_path("closed"), 0};
+    ofstream output(closed_file.path, ios::binary);
+    merge_sorted_files(
+        readers, num_bins, [&](const vector<int> &equal_readers) {
+            bool is_closed = false;
+            int num_new = 0;
+            const PackedStateBin *new_record = nullptr;
+            for (int reader : equal_readers) {
+                if (readers[reader]->is_closed) {
+                    is_closed = true;
+                } else if (num_new++ == 0) {
+                    new_record = readers[reader]->get_record();
+                }
+            }
+            if (is_closed) {
+                num_duplicates += num_new;
+            } else {
+                num_duplicates += num_new - 1;
+                output.write(reinterpret_cast<const char *>(new_record),
+                             record_size * sizeof(PackedStateBin));
+                ++closed_file.num_records;
+            }
+        });
+    if (!output) {
+        exit_with_file_error("write", closed_file.path);
+    }
+    output.close();
+    readers.clear();
+    for (const string &run_path : run_paths) {
+        filesystem::remove(run_path);
+    }
+    if (closed_file.num_records > 0) {
+        closed_files[h].push_back(closed_file);
+    } else {
+        filesystem::remove(closed_file.path);
+    }
+    return closed_file;
+}
+
+/*
+  Merges the newest closed files of the h-value while the newest file has
+  at least half as many records as the one before it. Then the file sizes
+  decrease geometrically, so there are logarithmically many closed files
+  per h-value and each record is rewritten logarithmically often.
+*/
+void ExternalAStarSearch::compact_closed_files(int h) {
+    vector<ClosedFile> &files = closed_files[h];
+    while (files.size() >= 2 &&
+           files[files.size() - 2].num_records <= 2 * files.back().num_records) {
+        vector<unique_ptr<RecordReader>> readers;
+        for (size_t i = files.size() - 2; i < files.size(); ++i) {
+            readers.push_back(make_unique<RecordReader>(files[i].path, record_size, true));
+        }
+        ClosedFile merged_file{get_new_file_path("closed"), 0};
+        ofstream output(merged_file.path, ios::binary);
+        merge_sorted_files(
+            readers, num_bins, [&](const vector<int> &equal_readers) {
+                // Closed files of the same h-value contain different states.
+                assert(equal_readers.size() == 1);
+                output.write(reinterpret_cast<const char *>(
+                                 readers[equal_readers[0]]->get_record()),
+                             record_size * sizeof(PackedStateBin));
+                ++merged_file.num_records;
+            });
+        if (!output) {
+            exit_with_file_error("write", merged_file.path);
+        }
+        readers.clear();
+        for (int i = 0; i < 2; ++i) {
+            filesystem::remove(files.back().path);
+            files.pop_back();
+        }
+        files.push_back(merged_file);
+        ++num_compactions;
+    }
+}
+
+bool ExternalAStarSearch::start_next_bucket() {
+    while (!open_buckets.empty()) {
+        auto [f, negated_g] = *open_buckets.begin();
+        int g = -negated_g;
+        open_buckets.erase(open_buckets.begin());
+        if (f > current_g + current_h) {
+            log << "f = " << f << ", " << statistics.get_expanded()
+                << " expanded, " << num_records_written
+                << " records written" << endl;
+        }
+        current_g = g;
+        current_h = f - g;
+        // The previous bucket is expanded completely, so its file can be merged.
+        expansion_file.close();
+        compact_closed_files(current_h);
+        ClosedFile closed_file = merge_bucket(current_g, current_h);
+        if (closed_file.num_records > 0) {
+            expansion_file = ifstream(closed_file.path, ios::binary);
+            if (!expansion_file) {
+                exit_with_file_error("open", closed_file.path);
+            }
+            records_left_to_expand = closed_file.num_records;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ExternalAStarSearch::initialize() {
+    log << "Conducting external-memory A* search, (real) bound = " << bound
+        << endl;
+    filesystem::path base_directory = directory_option.empty() ?
+        filesystem::temp_directory_path() : filesystem::path(directory_option);
+    directory = (base_directory / (
+                     "external_astar_" + to_string(utils::get_process_id()) +
+                     "_" + to_string(instance_count++))).string();
+    error_code error;
+    filesystem::create_directories(directory, error);
+    if (error) {
+        exit_with_file_error("create", directory);
+    }
+    log << "Storing the search space in " << directory << endl;
+
+    batch_registry = make_unique<StateRegistry>(task_proxy);
+    State initial_state = batch_registry->get_initial_state();
+    EvaluationContext eval_context(initial_state, 0, false, &statistics);
+    statistics.inc_evaluated_states();
+    print_initial_evaluator_values(eval_context);
+    if (eval_context.is_evaluator_value_infinite(evaluator.get())) {
+        log << "Initial state is a dead end." << endl;
+        return;
+    }
+    int h = eval_context.get_evaluator_value(evaluator.get());
+    Record record(record_size);
+    const PackedStateBin *buffer = initial_state.get_buffer();
+    copy(buffer, buffer + num_bins, record.begin());
+    copy(buffer, buffer + num_bins, record.begin() + num_bins);
+    record[2 * num_bins] = NO_OPERATOR;
+    record[2 * num_bins + 1] = 0;
+    record[2 * num_bins + 2] = 0;
+    add_record(0, h, record);
+}
+
+bool ExternalAStarSearch::expand(const Record &record) {
+    State state = create_state(record.data());
+    int real_g = record[2 * num_bins + 1];
+    int g = record[2 * num_bins + 2];
+    statistics.inc_expanded();
+    if (task_properties::is_goal_state(task_proxy, state)) {
+        log << "Solution found!" << endl;
+        Plan plan;
+        trace_path(record, plan);
+        set_plan(plan);
+        return true;
+    }
+
+    vector<OperatorID> applicable_ops;
+    successor_generator.generate_applicable_ops(state, applicable_ops);
+    statistics.inc_generated_ops(applicable_ops.size());
+    Record successor_record(record_size);
+    const PackedStateBin *buffer = state.get_buffer();
+    copy(buffer, buffer + num_bins, successor_record.begin() + num_bins);
+    for (OperatorID op_id : applicable_ops) {
+        OperatorProxy op = task_proxy.get_operators()[op_id];
+        if (real_g + op.get_cost() >= bound)
+            continue;
+        State succ_state = batch_registry->get_successor_state(state, op);
+        statistics.inc_generated();
+        int succ_g = g + get_adjusted_cost(op);
+        EvaluationContext eval_context(succ_state, succ_g, false, &statistics);
+        statistics.inc_evaluated_states();
+        if (eval_context.is_evaluator_value_infinite(evaluator.get())) {
+            statistics.inc_dead_ends();
+            continue;
+        }
+        int succ_h = eval_context.get_evaluator_value(evaluator.get());
+        const PackedStateBin *succ_buffer = succ_state.get_buffer();
+        copy(succ_buffer, succ_buffer + num_bins, successor_record.begin());
+        successor_record[2 * num_bins] = op_id.get_index();
+        successor_record[2 * num_bins + 1] = real_g + op.get_cost();
+        successor_record[2 * num_bins + 2] = succ_g;
+        add_record(succ_g, succ_h, successor_record);
+    }
+    return false;
+}
+
+SearchStatus ExternalAStarSearch::step() {
+    Record record(record_size);
+    for (int i = 0; i < EXPANSIONS_PER_STEP; ++i) {
+        if (records_left_to_expand == 0 && !start_next_bucket()) {
+            log << "Completely explored state space -- no solution!" << endl;
+            return FAILED;
+        }
+        expansion_file.read(reinterpret_cast<char *>(record.data()),
+                            record_size * sizeof(PackedStateBin));
+        if (!expansion_file) {
+            cerr << "external_astar: could not read a closed file" << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+        --records_left_to_expand;
+        if (++batch_size == MAX_BATCH_SIZE) {
+            // Evaluators drop their information about the old registry.
+            batch_registry = make_unique<StateRegistry>(task_proxy);
+            batch_size = 0;
+        }
+        if (expand(record)) {
+            return SOLVED;
+        }
+    }
+    return IN_PROGRESS;
+}
+
+// Looks up the record of the given state with binary search.
+bool ExternalAStarSearch::find_record(
+    const ClosedFile &file, const PackedStateBin *state, Record &record) const {
+    ifstream input(file.path, ios::binary);
+    int begin = 0;
+    int end = file.num_records;
+    while (begin < end) {
+        int middle = begin + (end - begin) / 2;
+        input.seekg(static_cast<streamoff>(middle) * record_size * sizeof(PackedStateBin));
+        input.read(reinterpret_cast<char *>(record.data()),
+                   record_size * sizeof(PackedStateBin));
+        if (!input) {
+            exit_with_file_error("read", file.path);
+        }
+        if (state_less(record.data(), state, num_bins)) {
+            begin = middle + 1;
+        } else if (state_less(state, record.data(), num_bins)) {
+            end = middle;
+        } else {
+            return true;
+        }
+    }
+    return false;
+}
+
+// The parent of each record on the plan is in exactly one closed file.
+void ExternalAStarSearch::trace_path(const Record &goal_record, Plan &plan) const {
+    assert(plan.empty());
+    Record record = goal_record;
+    while (record[2 * num_bins] != NO_OPERATOR) {
+        plan.push_back(OperatorID(record[2 * num_bins]));
+        Record parent_state(record.begin() + num_bins, record.begin() + 2 * num_bins);
+        bool found = false;
+        for (const auto &[h, files] : closed_files) {
+            for (const ClosedFile &file : files) {
+                if (find_record(file, parent_state.data(), record)) {
+                    found = true;
+                    break;
+                }
+            }
+            if (found)
+                break;
+        }
+        if (!found) {
+            cerr << "external_astar: could not find the parent of a state "
+                 << "on the plan" << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+    }
+    reverse(plan.begin(), plan.end());
+}
+
+void ExternalAStarSearch::print_statistics() const {
+    statistics.print_detailed_statistics();
+    log << "Records written to disk: " << num_records_written << endl;
+    log << "Duplicate records removed: " << num_duplicates << endl;
+    log << "Sorted runs: " << num_sorted_runs << endl;
+    int num_closed_files = 0;
+    for (const auto &[h, files] : closed_files) {
+        num_closed_files += files.size();
+    }
+    log << "Closed files: " << num_closed_files << endl;
+    log << "Closed file merges: " << num_compactions << endl;
+}
+
+class ExternalAStarSearchFeature
+    : public plugins::TypedFeature<SearchAlgorithm, ExternalAStarSearch> {
+public:
+    ExternalAStarSearchFeature() : TypedFeature("external_astar") {
+        document_title("External-memory A* search");
+        document_synopsis(
+            "A* search that stores the open and closed lists on disk in "
+            "buckets of states with equal g- and h-values and detects "
+            "duplicates in batches by sorting and merging the buckets "
+            "(Edelkamp, Jabbar and Schrödl, 2004). Only the records that are "
+            "sorted at once and a bounded number of evaluated states are kept "
+            "in memory, so the search can solve tasks whose state spaces do "
+            "not fit into memory, at the cost of disk accesses.");
+
+        add_option<shared_ptr<Evaluator>>("eval", "evaluator for h-value");
+        add_option<string>(
+            "directory",
+            "directory in which the search creates a subdirectory for its "
+            "files. The subdirectory is deleted when the search ends. The "
+            "empty string stands for the temporary directory of the system.",
+            "\"\"");
+        add_option<int>(
+            "max_sorted_records",
+            "maximum number of records that are buffered and sorted in "
+            "memory at once. Larger values need fewer sorted runs, but more "
+            "memory.",
+            "1000000",
+            plugins::Bounds("1", "infinity"));
+        SearchAlgorithm::add_options_to_feature(*this);
+
+        document_note(
+            "Optimality",
+            "Duplicates are only detected among states with equal h-values, "
+            "and a state is never reopened. The search is therefore only "
+            "guaranteed to find optimal plans with consistent heuristics.");
+        document_note(
+            "Limitations",
+            "Path-dependent evaluators are not supported. Operators with "
+            "cost 0 are supported, but lead to repeated merges of the same "
+            "bucket.");
+    }
+
+    virtual shared_ptr<ExternalAStarSearch> create_component(
+        const plugins::Options &options, const utils::Context &) const override {
+        return make_shared<ExternalAStarSearch>(options);
+    }
+};
+
+static plugins::FeaturePlugin<ExternalAStarSearchFeature> _plugin;
+}
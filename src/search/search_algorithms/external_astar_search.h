@@ -0,0 +1,110 @@
+#ifndef SEARCH_ALGORITHMS_EXTERNAL_ASTAR_SEARCH_H
+#define SEARCH_ALGORITHMS_EXTERNAL_ASTAR_SEARCH_H
+
+#include "../search_algorithm.h"
+
+#include <fstream>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+class Evaluator;
+
+namespace plugins {
+class Feature;
+}
+
+namespace external_astar_search {
+/*
+  External A* (Edelkamp, Jabbar and Schrödl, 2004) keeps the search space on
+  disk instead of in a state registry. States are grouped into buckets of
+  equal g- and h-values. Each bucket is a file of records, and a record
+  holds a packed state, the packed parent state, the creating operator, the
+  real g-value and the g-value. Buckets are expanded in the order of increasing f-values
+  and, among equal f-values, decreasing g-values, so goal states are
+  expanded as early as possible.
+
+  Generated states are appended to their bucket without duplicate
+  detection. Before a bucket is expanded, its records are sorted in runs
+  that fit into memory, and the runs are merged with the closed files of
+  all buckets with the same h-value (a state always has the same h-value).
+  Records of states that occur in a closed file or earlier in the merge are
+  dropped (delayed duplicate detection), the remaining records are written
+  to a new sorted closed file and then expanded. Closed files of the same
+  h-value are merged regularly to keep their number logarithmic.
+*/
+using Record = std::vector<PackedStateBin>;
+
+struct ClosedFile {
+    std::string path;
+    int num_records;
+};
+
+class ExternalAStarSearch : public SearchAlgorithm {
+    const std::shared_ptr<Evaluator> evaluator;
+    const std::string directory_option;
+    const int max_sorted_records;
+
+    const int_packer::IntPacker &state_packer;
+    const int num_bins;
+    const int record_size;
+    std::string directory;
+    int next_file_id;
+
+    // Keys (f, -g) of the non-empty open buckets.
+    std::set<std::pair<int, int>> open_buckets;
+    // Records that were not written to the bucket files yet, by (g, h).
+    std::map<std::pair<int, int>, std::vector<PackedStateBin>> write_buffers;
+    int num_buffered_records;
+    // Closed files by h-value.
+    std::map<int, std::vector<ClosedFile>> closed_files;
+
+    // The closed file that is expanded at the moment, and its bucket.
+    std::ifstream expansion_file;
+    int records_left_to_expand;
+    int current_g;
+    int current_h;
+
+    /*
+      Registers the states of the records expanded at the moment, so that
+      evaluators can cache per-state information. It is replaced regularly
+      to keep its memory bounded.
+    */
+    std::unique_ptr<StateRegistry> batch_registry;
+    int batch_size;
+
+    long long num_duplicates;
+    long long num_records_written;
+    int num_sorted_runs;
+    int num_compactions;
+
+    std::string get_new_file_path(const std::string &prefix);
+    State create_state(const PackedStateBin *bins);
+    void add_record(int g, int h, const Record &record);
+    void flush_write_buffer(int g, int h);
+    void flush_write_buffers();
+    std::vector<std::string> sort_bucket(const std::string &bucket_path);
+    ClosedFile merge_bucket(int g, int h);
+    void compact_closed_files(int h);
+    bool start_next_bucket();
+    bool expand(const Record &record);
+    bool find_record(const ClosedFile &file, const PackedStateBin *state,
+                     Record &record) const;
+    void trace_path(const Record &goal_record, Plan &plan) const;
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    explicit ExternalAStarSearch(const plugins::Options &opts);
+    virtual ~ExternalAStarSearch() override;
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
@@ -0,0 +1,423 @@
+#include "hdastar_search.h"
+
+#include "search_common.h"
+
+#include "../evaluation_context.h"
+#include "../evaluator.h"
+#include "../open_list_factory.h"
+#include "../pruning_method.h"
+
+#include "../plugins/plugin.h"
+#include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/countdown_timer.h"
+#include "../utils/hash.h"
+#include "../utils/logging.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <set>
+#include <thread>
+
+using namespace std;
+
+namespace hdastar_search {
+// Workers send messages in batches of this size at most.
+static const size_t MAX_BATCH_SIZE = 64;
+// Workers send their pending messages after this many expansions at the latest.
+static const int FLUSH_INTERVAL = 16;
+
+MessageQueue::MessageQueue()
+    : head(nullptr) {
+}
+
+MessageQueue::~MessageQueue() {
+    Batch *batch = head.load();
+    while (batch) {
+        Batch *next = batch->next;
+        delete batch;
+        batch = next;
+    }
+}
+
+void MessageQueue::push(vector<Message> &&messages) {
+    Batch *batch = new Batch{move(messages), head.load(memory_order_relaxed)};
+    while (!head.compare_exchange_weak(
+               batch->next, batch, memory_order_release, memory_order_relaxed)) {
+    }
+}
+
+void MessageQueue::take_all(vector<Message> &messages) {
+    Batch *batch = head.exchange(nullptr, memory_order_acquire);
+    while (batch) {
+        messages.insert(messages.end(), batch->messages.begin(), batch->messages.end());
+        Batch *next = batch->next;
+        delete batch;
+        batch = next;
+    }
+}
+
+
+template<typename T>
+static T construct_for_worker(const parser::LazyValue &config) {
+    try {
+        return config.construct<T>();
+    } catch (const utils::ContextError &e) {
+        cerr << "Delayed construction of LazyValue failed" << endl;
+        cerr << e.get_message() << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+}
+
+HDAStarSearch::HDAStarSearch(const plugins::Options &opts)
+    : SearchAlgorithm(opts, true),
+      num_threads(opts.get<int>("num_threads")),
+      h_evaluator_config(opts.get<parser::LazyValue>("eval")),
+      pruning_method_config(opts.get<parser::LazyValue>("pruning")),
+      pending_work(0),
+      stop(false),
+      incumbent_cost(numeric_limits<int>::max()),
+      incumbent_goal(StateID::no_state),
+      abort_status(IN_PROGRESS) {
+    for (int i = 0; i < num_threads; ++i) {
+        unique_ptr<Worker> worker = utils::make_unique_ptr<Worker>(log);
+        worker->h_evaluator =
+            construct_for_worker<shared_ptr<Evaluator>>(h_evaluator_config);
+        worker->pruning_method =
+            construct_for_worker<shared_ptr<PruningMethod>>(pruning_method_config);
+        if (i > 0 && (worker->h_evaluator == workers[0]->h_evaluator ||
+                      worker->pruning_method == workers[0]->pruning_method)) {
+            cerr << "hdastar needs one evaluator and pruning method per thread. "
+                 << "Please do not predefine them with --evaluator or let."
+                 << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+        }
+
+        plugins::Options astar_opts;
+        astar_opts.set("eval", worker->h_evaluator);
+        astar_opts.set("verbosity", opts.get<utils::Verbosity>("verbosity"));
+        auto [open_list_factory, f_evaluator] =
+            search_common::create_astar_open_list_factory_and_f_eval(astar_opts);
+        worker->open_list = open_list_factory->create_state_open_list();
+        worker->f_evaluator = f_evaluator;
+
+        set<Evaluator *> path_dependent_evaluators;
+        worker->open_list->get_path_dependent_evaluators(path_dependent_evaluators);
+        if (!path_dependent_evaluators.empty()) {
+            cerr << "hdastar does not support path-dependent evaluators." << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+        }
+        worker->outboxes.resize(num_threads);
+        workers.push_back(move(worker));
+    }
+}
+
+void HDAStarSearch::initialize() {
+    log << "Conducting hash-distributed A* search with " << num_threads
+        << " threads, (real) bound = " << bound << endl;
+
+    for (const unique_ptr<Worker> &worker : workers) {
+        worker->pruning_method->initialize(task);
+    }
+
+    State initial_state = state_registry.get_initial_state();
+    Worker &owner = *workers[get_owner(initial_state.get_id())];
+    EvaluationContext eval_context(initial_state, 0, true, &owner.statistics);
+    owner.statistics.inc_evaluated_states();
+    if (owner.open_list->is_dead_end(eval_context)) {
+        log << "Initial state is a dead end." << endl;
+    } else {
+        SearchNodeInfo &info = search_nodes[initial_state];
+        info.status = SearchNodeInfo::OPEN;
+        info.g = 0;
+        info.real_g = 0;
+        owner.open_list->insert(eval_context, initial_state.get_id());
+    }
+    print_initial_evaluator_values(eval_context);
+}
+
+int HDAStarSearch::get_owner(StateID id) const {
+    return utils::get_hash(id) % num_threads;
+}
+
+void HDAStarSearch::send(int owner, vector<Message> &outbox) {
+    // Count the messages before they become visible to the receiver.
+    pending_work += outbox.size();
+    workers[owner]->inbox.push(move(outbox));
+    outbox.clear();
+}
+
+void HDAStarSearch::flush_outboxes(Worker &worker) {
+    for (int owner = 0; owner < num_threads; ++owner) {
+        if (!worker.outboxes[owner].empty()) {
+            send(owner, worker.outboxes[owner]);
+        }
+    }
+}
+
+void HDAStarSearch::receive(Worker &worker, const Message &message) {
+    State state = state_registry.lookup_state(message.state);
+    SearchNodeInfo &info = search_nodes[state];
+    if (info.status == SearchNodeInfo::DEAD_END) {
+        return;
+    }
+    if (info.status == SearchNodeInfo::NEW) {
+        EvaluationContext eval_context(state, message.g, false, &worker.statistics);
+        worker.statistics.inc_evaluated_states();
+        if (worker.open_list->is_dead_end(eval_context)) {
+            info.status = SearchNodeInfo::DEAD_END;
+            worker.statistics.inc_dead_ends();
+            return;
+        }
+        info.status = SearchNodeInfo::OPEN;
+        info.g = message.g;
+        info.real_g = message.real_g;
+        info.parent_state_id = message.parent;
+        info.creating_operator = message.creating_operator;
+        worker.open_list->insert(eval_context, message.state);
+    } else if (message.g < info.g) {
+        // We found a cheaper path to an open or closed state.
+        if (info.status == SearchNodeInfo::CLOSED) {
+            worker.statistics.inc_reopened();
+        }
+        info.status = SearchNodeInfo::OPEN;
+        info.g = message.g;
+        info.real_g = message.real_g;
+        info.parent_state_id = message.parent;
+        info.creating_operator = message.creating_operator;
+        EvaluationContext eval_context(state, message.g, false, &worker.statistics);
+        worker.open_list->insert(eval_context, message.state);
+    }
+}
+
+void HDAStarSearch::report_goal(const State &state, int g) {
+    lock_guard<mutex> lock(incumbent_mutex);
+    if (g < incumbent_cost) {
+        incumbent_cost = g;
+        incumbent_goal = state.get_id();
+    }
+}
+
+bool HDAStarSearch::expand(int worker_id, Worker &worker) {
+    while (true) {
+        if (worker.open_list->empty()) {
+            return false;
+        }
+        StateID id = worker.open_list->remove_min();
+        State state = state_registry.lookup_state(id);
+        SearchNodeInfo &info = search_nodes[state];
+        if (info.status == SearchNodeInfo::CLOSED) {
+            continue;
+        }
+        EvaluationContext eval_context(state, info.g, false, &worker.statistics);
+        int f = eval_context.get_evaluator_value_or_infinity(worker.f_evaluator.get());
+        if (f >= incumbent_cost) {
+            /*
+              The open list is ordered by f-values and the heuristic is
+              admissible, so no open state leads to a cheaper plan. The
+              incumbent cost never increases, so we can drop them all.
+            */
+            worker.open_list->clear();
+            return false;
+        }
+        info.status = SearchNodeInfo::CLOSED;
+        worker.statistics.inc_expanded();
+        if (task_properties::is_goal_state(task_proxy, state)) {
+            report_goal(state, info.g);
+            continue;
+        }
+
+        vector<OperatorID> applicable_ops;
+        successor_generator.generate_applicable_ops(state, applicable_ops);
+        worker.pruning_method->prune_operators(state, applicable_ops);
+        for (OperatorID op_id : applicable_ops) {
+            OperatorProxy op = task_proxy.get_operators()[op_id];
+            if (info.real_g + op.get_cost() >= bound)
+                continue;
+            State succ_state = state_registry.get_successor_state(state, op);
+            worker.statistics.inc_generated();
+            Message message{succ_state.get_id(), id, op_id,
+                            info.g + get_adjusted_cost(op),
+                            info.real_g + op.get_cost()};
+            if (message.g >= incumbent_cost)
+                continue;
+            int owner = get_owner(message.state);
+            if (owner == worker_id) {
+                receive(worker, message);
+            } else {
+                vector<Message> &outbox = worker.outboxes[owner];
+                outbox.push_back(message);
+                if (outbox.size() >= MAX_BATCH_SIZE) {
+                    send(owner, outbox);
+                }
+            }
+        }
+        return true;
+    }
+}
+
+void HDAStarSearch::run_worker(int worker_id) {
+    Worker &worker = *workers[worker_id];
+    bool active = true;
+    int expansions_since_flush = 0;
+    vector<Message> received;
+    while (!stop) {
+        // Only the first worker uses the timer of the search algorithm.
+        if (worker_id == 0 && (timer->is_expired() || utils::is_out_of_memory())) {
+            abort_status = timer->is_expired() ? TIMEOUT : OOM;
+            stop = true;
+            break;
+        }
+
+        received.clear();
+        worker.inbox.take_all(received);
+        if (!received.empty()) {
+            if (!active) {
+                ++pending_work;
+                active = true;
+            }
+            for (const Message &message : received) {
+                receive(worker, message);
+            }
+            pending_work -= received.size();
+        }
+
+        if (active) {
+            bool expanded = expand(worker_id, worker);
+            if (!expanded || ++expansions_since_flush == FLUSH_INTERVAL) {
+                flush_outboxes(worker);
+                expansions_since_flush = 0;
+            }
+            if (!expanded) {
+                active = false;
+                --pending_work;
+            }
+        } else if (pending_work == 0) {
+            // No worker is active and no message is in transit.
+            stop = true;
+        } else {
+            this_thread::yield();
+        }
+    }
+}
+
+SearchStatus HDAStarSearch::step() {
+    pending_work = num_threads;
+    vector<thread> threads;
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back(&HDAStarSearch::run_worker, this, i);
+    }
+    for (thread &worker_thread : threads) {
+        worker_thread.join();
+    }
+
+    for (const unique_ptr<Worker> &worker : workers) {
+        const SearchStatistics &worker_statistics = worker->statistics;
+        statistics.inc_expanded(worker_statistics.get_expanded());
+        statistics.inc_evaluated_states(worker_statistics.get_evaluated_states());
+        statistics.inc_evaluations(worker_statistics.get_evaluations());
+        statistics.inc_generated(worker_statistics.get_generated());
+        statistics.inc_reopened(worker_statistics.get_reopened());
+        statistics.inc_dead_ends(worker_statistics.get_dead_ends());
+    }
+
+    if (abort_status != IN_PROGRESS) {
+        return abort_status;
+    }
+    if (incumbent_goal == StateID::no_state) {
+        log << "Completely explored state space -- no solution!" << endl;
+        return FAILED;
+    }
+    log << "Solution found!" << endl;
+    Plan plan;
+    trace_path(incumbent_goal, plan);
+    set_plan(plan);
+    return SOLVED;
+}
+
+void HDAStarSearch::trace_path(StateID goal, Plan &plan) const {
+    assert(plan.empty());
+    StateID current = goal;
+    while (true) {
+        const SearchNodeInfo &info = search_nodes[state_registry.lookup_state(current)];
+        if (info.creating_operator == OperatorID::no_operator) {
+            assert(info.parent_state_id == StateID::no_state);
+            break;
+        }
+        plan.push_back(info.creating_operator);
+        current = info.parent_state_id;
+    }
+    reverse(plan.begin(), plan.end());
+}
+
+void HDAStarSearch::print_statistics() const {
+    statistics.print_detailed_statistics();
+    for (int i = 0; i < num_threads; ++i) {
+        log << "Worker " << i << " expanded "
+            << workers[i]->statistics.get_expanded() << " state(s)." << endl;
+    }
+    search_space.print_statistics();
+    for (const unique_ptr<Worker> &worker : workers) {
+        worker->pruning_method->print_statistics();
+    }
+}
+
+class HDAStarSearchFeature : public plugins::TypedFeature<SearchAlgorithm, HDAStarSearch> {
+public:
+    HDAStarSearchFeature() : TypedFeature("hdastar") {
+        document_title("Hash-distributed A* search");
+        document_synopsis(
+            "Parallel A* search (Kishimoto, Fukunaga and Botea, 2009). Every "
+            "state belongs to one of several worker threads, determined by its "
+            "hash value. Each worker expands its own states in the same order "
+            "as astar() would and sends the generated states to their owners "
+            "through lock-free queues. Plans are optimal for admissible "
+            "heuristics.");
+
+        add_option<shared_ptr<Evaluator>>(
+            "eval",
+            "evaluator for h-value. Every thread constructs its own instance, "
+            "so the evaluator must be defined inline and not with "
+            "--evaluator or let.",
+            "",
+            plugins::Bounds::unlimited(),
+            true);
+        add_option<int>(
+            "num_threads",
+            "number of worker threads",
+            "4",
+            plugins::Bounds("1", "infinity"));
+        add_option<shared_ptr<PruningMethod>>(
+            "pruning",
+            "Pruning methods can prune or reorder the set of applicable operators in "
+            "each state and thereby influence the number and order of successor states "
+            "that are considered. Every thread constructs its own instance.",
+            "null()",
+            plugins::Bounds::unlimited(),
+            true);
+        SearchAlgorithm::add_options_to_feature(*this);
+
+        document_note(
+            "Termination",
+            "A worker that finds a goal state with a cheaper plan than all "
+            "previous ones stores it as the incumbent plan, and all workers "
+            "discard states whose f-value is at least its cost. The search "
+            "stops when no worker has states left and no states are in transit "
+            "between workers. Then no open state can lead to a cheaper plan, "
+            "so the incumbent plan is optimal.");
+        document_note(
+            "Limitations",
+            "Path-dependent evaluators and lazy evaluators are not supported. "
+            "The state registry is shared by all threads and cannot use "
+            "compressed state storage.");
+    }
+
+    virtual shared_ptr<HDAStarSearch> create_component(const plugins::Options &options, const utils::Context &) const override {
+        return make_shared<HDAStarSearch>(options);
+    }
+};
+
+static plugins::FeaturePlugin<HDAStarSearchFeature> _plugin;
+}
@@ -0,0 +1,121 @@
+#ifndef SEARCH_ALGORITHMS_HDASTAR_SEARCH_H
+#define SEARCH_ALGORITHMS_HDASTAR_SEARCH_H
+
+#include "../open_list.h"
+#include "../per_state_information.h"
+#include "../search_algorithm.h"
+#include "../search_node_info.h"
+
+#include "../parser/decorated_abstract_syntax_tree.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class Evaluator;
+class PruningMethod;
+
+namespace plugins {
+class Feature;
+}
+
+namespace hdastar_search {
+/*
+  A generated state sent to the worker that owns it, together with the path
+  on which it was reached.
+*/
+struct Message {
+    StateID state;
+    StateID parent;
+    OperatorID creating_operator;
+    int g;
+    int real_g;
+};
+
+/*
+  Multiple-producer single-consumer queue of message batches. Producers push
+  batches with a compare-and-swap loop, the consumer takes all batches at
+  once, so no operation blocks and no batch is ever removed individually
+  (which avoids the ABA problem of lock-free stacks).
+*/
+class MessageQueue {
+    struct Batch {
+        std::vector<Message> messages;
+        Batch *next;
+    };
+    std::atomic<Batch *> head;
+public:
+    MessageQueue();
+    ~MessageQueue();
+    MessageQueue(const MessageQueue &) = delete;
+    MessageQueue &operator=(const MessageQueue &) = delete;
+
+    void push(std::vector<Message> &&messages);
+    // Appends all pushed messages to messages (in no particular order).
+    void take_all(std::vector<Message> &messages);
+};
+
+class HDAStarSearch : public SearchAlgorithm {
+    struct Worker {
+        std::shared_ptr<Evaluator> h_evaluator;
+        std::shared_ptr<Evaluator> f_evaluator;
+        std::unique_ptr<StateOpenList> open_list;
+        std::shared_ptr<PruningMethod> pruning_method;
+        SearchStatistics statistics;
+        MessageQueue inbox;
+        // Messages for the other workers that have not been sent yet.
+        std::vector<std::vector<Message>> outboxes;
+
+        explicit Worker(utils::LogProxy &log)
+            : statistics(log) {
+        }
+    };
+
+    const int num_threads;
+    const parser::LazyValue h_evaluator_config;
+    const parser::LazyValue pruning_method_config;
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    /*
+      Each state belongs to one worker, which is the only thread that reads
+      or writes its search node.
+    */
+    PerStateInformation<SearchNodeInfo> search_nodes;
+
+    /*
+      Number of workers that are not idle plus the number of messages that
+      were sent but not processed yet. The search space is exhausted when
+      this reaches 0, and it never increases again afterwards.
+    */
+    std::atomic<long long> pending_work;
+    std::atomic<bool> stop;
+    // (Adjusted) cost of the best plan found so far.
+    std::atomic<int> incumbent_cost;
+    std::mutex incumbent_mutex;
+    StateID incumbent_goal;
+    SearchStatus abort_status;
+
+    int get_owner(StateID id) const;
+    void send(int owner, std::vector<Message> &outbox);
+    void flush_outboxes(Worker &worker);
+    void receive(Worker &worker, const Message &message);
+    // Returns false if the worker has nothing to expand.
+    bool expand(int worker_id, Worker &worker);
+    void report_goal(const State &state, int g);
+    void run_worker(int worker_id);
+    void trace_path(StateID goal, Plan &plan) const;
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    explicit HDAStarSearch(const plugins::Options &opts);
+    virtual ~HDAStarSearch() override = default;
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
@@ -33,7 +33,7 @@ public:
             "\n```\n--search astar(evaluator)\n```\n"
             "is equivalent to\n"
             "```\n--evaluator h=evaluator\n"
-            "--search eager(tiebreaking([sum([g(), h]), h], unsafe_pruning=false),\n"
+            "--search eager(bucket([sum([g(), h]), h], unsafe_pruning=false),\n"
             "               reopen_closed=true, f_eval=sum([g(), h]))\n"
             "```\n", true);
     }
@@ -8,7 +8,7 @@
 #include "../plugins/options.h"
 #include "../open_lists/alternation_open_list.h"
 #include "../open_lists/best_first_open_list.h"
-#include "../open_lists/tiebreaking_open_list.h"
+#include "../open_lists/bucket_open_list.h"
 
 #include <memory>
 
@@ -144,8 +144,9 @@ create_astar_open_list_factory_and_f_eval(const plugins::Options &opts) {
     options.set("evals", evals);
     options.set("pref_only", false);
     options.set("unsafe_pruning", false);
+    options.set("max_dense_key", 4096);
     shared_ptr<OpenListFactory> open =
-        make_shared<tiebreaking_open_list::TieBreakingOpenListFactory>(options);
+        make_shared<bucket_open_list::BucketOpenListFactory>(options);
     return make_pair(open, f);
 }
 }
@@ -49,6 +49,11 @@ public:
         return std::to_string(value);
     }
 
+    // Returns the index of the state in its registry.
+    int get_value() const {
+        return value;
+    }
+
     void feed_to_hash_state(utils::HashState &hash_state) const;
 };
 
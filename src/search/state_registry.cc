@@ -6,17 +6,64 @@
 #include "task_utils/task_properties.h"
 #include "utils/logging.h"
 
+#include <random>
+
 using namespace std;
 
-StateRegistry::StateRegistry(const TaskProxy &task_proxy)
+StateRegistry::StateRegistry(
+    const TaskProxy &task_proxy, bool concurrent, StateHashing hashing,
+    StateStorage storage, int compressed_leaf_size)
     : task_proxy(task_proxy),
       state_packer(task_properties::g_state_packers[task_proxy]),
       axiom_evaluator(g_axiom_evaluators[task_proxy]),
       num_variables(task_proxy.get_variables().size()),
-      state_data_pool(get_bins_per_state()),
-      registered_states(
-          StateIDSemanticHash(state_data_pool, get_bins_per_state()),
-          StateIDSemanticEqual(state_data_pool, get_bins_per_state())) {
+      concurrent(concurrent),
+      storage(storage),
+      hashing(storage == StateStorage::TREE_COMPRESSED ? StateHashing::FULL : hashing) {
+    if (concurrent && storage == StateStorage::TREE_COMPRESSED) {
+        cerr << "Compressed state storage is not supported by concurrent "
+             << "state registries." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+    if (hashing == StateHashing::INCREMENTAL) {
+        // A fixed seed makes hashes and hence search behavior reproducible.
+        mt19937 rng(2024);
+        for (VariableProxy var : task_proxy.get_variables()) {
+            zobrist_offsets.push_back(zobrist_keys.size());
+            for (int value = 0; value < var.get_domain_size(); ++value) {
+                zobrist_keys.push_back(rng());
+            }
+        }
+    }
+    int num_bins = get_bins_per_state();
+    int num_stored_bins = get_stored_bins_per_state();
+    if (concurrent) {
+        concurrent_state_data_pool.emplace(num_stored_bins);
+        shards = make_unique<StateShard[]>(NUM_SHARDS);
+    } else if (storage == StateStorage::TREE_COMPRESSED) {
+        compressed_state_data.emplace(num_bins, compressed_leaf_size);
+        decompression_buffer.resize(num_bins);
+    } else {
+        state_data_pool.emplace(num_stored_bins);
+        registered_states.emplace(
+            StateIDSemanticHash(*state_data_pool, num_bins,
+                                hashing == StateHashing::INCREMENTAL),
+            StateIDSemanticEqual(*state_data_pool, num_bins));
+    }
+}
+
+int_hash_set::HashType StateRegistry::compute_zobrist_hash(const vector<int> &values) const {
+    int_hash_set::HashType hash = 0;
+    for (int var = 0; var < num_variables; ++var) {
+        hash ^= get_zobrist_key(var, values[var]);
+    }
+    return hash;
+}
+
+void StateRegistry::set_stored_hash(PackedStateBin *buffer, const vector<int> &values) const {
+    if (hashing == StateHashing::INCREMENTAL) {
+        buffer[get_bins_per_state()] = compute_zobrist_hash(values);
+    }
 }
 
 StateID StateRegistry::insert_id_or_pop_state() {
@@ -26,30 +73,99 @@ StateID StateRegistry::insert_id_or_pop_state() {
       is present), we have to remove the duplicate entry from the
       state data pool.
     */
-    StateID id(state_data_pool.size() - 1);
-    pair<int, bool> result = registered_states.insert(id.value);
+    StateID id(state_data_pool->size() - 1);
+    pair<int, bool> result = registered_states->insert(id.value);
     bool is_new_entry = result.second;
     if (!is_new_entry) {
-        state_data_pool.pop_back();
+        state_data_pool->pop_back();
     }
-    assert(registered_states.size() == static_cast<int>(state_data_pool.size()));
+    assert(registered_states->size() == static_cast<int>(state_data_pool->size()));
     return StateID(result.first);
 }
 
+StateID StateRegistry::insert_compressed_state(const PackedStateBin *buffer) {
+    return StateID(compressed_state_data->insert(buffer).first);
+}
+
+vector<int> StateRegistry::unpack_state_data(const PackedStateBin *buffer) const {
+    vector<int> values(num_variables);
+    for (int var = 0; var < num_variables; ++var) {
+        values[var] = state_packer.get(buffer, var);
+    }
+    return values;
+}
+
+StateID StateRegistry::insert_state_data_concurrently(const PackedStateBin *buffer) {
+    int num_bins = get_bins_per_state();
+    int_hash_set::HashType hash = hashing == StateHashing::INCREMENTAL ?
+        buffer[num_bins] : hash_state_data(buffer, num_bins);
+    // The low bits select the shard, so we use the remaining bits for the slot.
+    StateShard &shard = shards[hash % NUM_SHARDS];
+    lock_guard<mutex> lock(shard.mutex);
+    if (2 * (shard.num_entries + 1) > static_cast<int>(shard.slots.size())) {
+        grow_shard(shard);
+    }
+    size_t mask = shard.slots.size() - 1;
+    for (size_t pos = (hash / NUM_SHARDS) & mask;; pos = (pos + 1) & mask) {
+        pair<int_hash_set::HashType, int> &slot = shard.slots[pos];
+        if (slot.second == -1) {
+            slot.first = hash;
+            slot.second = concurrent_state_data_pool->push_back(buffer);
+            ++shard.num_entries;
+            return StateID(slot.second);
+        }
+        if (slot.first == hash) {
+            const PackedStateBin *data = (*concurrent_state_data_pool)[slot.second];
+            if (equal(data, data + num_bins, buffer)) {
+                return StateID(slot.second);
+            }
+        }
+    }
+}
+
+void StateRegistry::grow_shard(StateShard &shard) const {
+    vector<pair<int_hash_set::HashType, int>> old_slots(
+        max<size_t>(16, 2 * shard.slots.size()), make_pair(0, -1));
+    swap(old_slots, shard.slots);
+    size_t mask = shard.slots.size() - 1;
+    for (const pair<int_hash_set::HashType, int> &slot : old_slots) {
+        if (slot.second == -1) {
+            continue;
+        }
+        size_t pos = (slot.first / NUM_SHARDS) & mask;
+        while (shard.slots[pos].second != -1) {
+            pos = (pos + 1) & mask;
+        }
+        shard.slots[pos] = slot;
+    }
+}
+
 State StateRegistry::lookup_state(StateID id) const {
-    const PackedStateBin *buffer = state_data_pool[id.value];
+    if (storage == StateStorage::TREE_COMPRESSED) {
+        compressed_state_data->get(id.value, decompression_buffer.data());
+        return task_proxy.create_state(
+            *this, id, nullptr, unpack_state_data(decompression_buffer.data()));
+    }
+    const PackedStateBin *buffer = get_state_data(id);
     return task_proxy.create_state(*this, id, buffer);
 }
 
 State StateRegistry::lookup_state(
     StateID id, vector<int> &&state_values) const {
-    const PackedStateBin *buffer = state_data_pool[id.value];
+    if (storage == StateStorage::TREE_COMPRESSED) {
+        return task_proxy.create_state(*this, id, nullptr, std::move(state_values));
+    }
+    const PackedStateBin *buffer = get_state_data(id);
     return task_proxy.create_state(*this, id, buffer, std::move(state_values));
 }
 
 const State &StateRegistry::get_initial_state() {
+    unique_lock<mutex> lock(initial_state_mutex, defer_lock);
+    if (concurrent) {
+        lock.lock();
+    }
     if (!cached_initial_state) {
-        int num_bins = get_bins_per_state();
+        int num_bins = get_stored_bins_per_state();
         unique_ptr<PackedStateBin[]> buffer(new PackedStateBin[num_bins]);
         // Avoid garbage values in half-full bins.
         fill_n(buffer.get(), num_bins, 0);
@@ -58,26 +174,23 @@ const State &StateRegistry::get_initial_state() {
         for (size_t i = 0; i < initial_state.size(); ++i) {
             state_packer.set(buffer.get(), i, initial_state[i].get_value());
         }
-        state_data_pool.push_back(buffer.get());
-        StateID id = insert_id_or_pop_state();
+        set_stored_hash(buffer.get(), initial_state.get_unpacked_values());
+        StateID id = StateID::no_state;
+        if (concurrent) {
+            id = insert_state_data_concurrently(buffer.get());
+        } else if (storage == StateStorage::TREE_COMPRESSED) {
+            id = insert_compressed_state(buffer.get());
+        } else {
+            state_data_pool->push_back(buffer.get());
+            id = insert_id_or_pop_state();
+        }
         cached_initial_state = utils::make_unique_ptr<State>(lookup_state(id));
     }
     return *cached_initial_state;
 }
 
-//TODO it would be nice to move the actual state creation (and operator application)
-//     out of the StateRegistry. This could for example be done by global functions
-//     operating on state buffers (PackedStateBin *).
-State StateRegistry::get_successor_state(const State &predecessor, const OperatorProxy &op) {
-    assert(!op.is_axiom());
-    /*
-      TODO: ideally, we would not modify state_data_pool here and in
-      insert_id_or_pop_state, but only at one place, to avoid errors like
-      buffer becoming a dangling pointer. This used to be a bug before being
-      fixed in https://issues.fast-downward.org/issue1115.
-    */
-    state_data_pool.push_back(predecessor.get_buffer());
-    PackedStateBin *buffer = state_data_pool[state_data_pool.size() - 1];
+vector<int> StateRegistry::apply_operator(
+    const State &predecessor, const OperatorProxy &op, PackedStateBin *buffer) {
     /* Experiments for issue348 showed that for tasks with axioms it's faster
        to compute successor states using unpacked data. */
     if (task_properties::has_axioms(task_proxy)) {
@@ -89,16 +202,45 @@ State StateRegistry::get_successor_state(const State &predecessor, const Operato
                 new_values[effect_pair.var] = effect_pair.value;
             }
         }
-        axiom_evaluator.evaluate(new_values);
+        {
+            unique_lock<mutex> lock(axiom_mutex, defer_lock);
+            if (concurrent) {
+                lock.lock();
+            }
+            axiom_evaluator.evaluate(new_values);
+        }
         for (size_t i = 0; i < new_values.size(); ++i) {
             state_packer.set(buffer, i, new_values[i]);
         }
-        /*
-          NOTE: insert_id_or_pop_state possibly invalidates buffer, hence
-          we use lookup_state to retrieve the state using the correct buffer.
-        */
-        StateID id = insert_id_or_pop_state();
-        return lookup_state(id, std::move(new_values));
+        if (hashing == StateHashing::INCREMENTAL) {
+            // Axioms may change any derived variable, so we compare all values.
+            const vector<int> &old_values = predecessor.get_unpacked_values();
+            PackedStateBin &hash = buffer[get_bins_per_state()];
+            for (int var = 0; var < num_variables; ++var) {
+                if (old_values[var] != new_values[var]) {
+                    hash ^= get_zobrist_key(var, old_values[var]) ^
+                        get_zobrist_key(var, new_values[var]);
+                }
+            }
+        }
+        return new_values;
+    } else if (hashing == StateHashing::INCREMENTAL) {
+        PackedStateBin &hash = buffer[get_bins_per_state()];
+        for (EffectProxy effect : op.get_effects()) {
+            if (does_fire(effect, predecessor)) {
+                FactPair effect_pair = effect.get_fact().get_pair();
+                /* We compare with the value in the buffer rather than in the
+                   predecessor because an earlier effect may have set the
+                   variable already. */
+                int old_value = state_packer.get(buffer, effect_pair.var);
+                if (old_value != effect_pair.value) {
+                    hash ^= get_zobrist_key(effect_pair.var, old_value) ^
+                        get_zobrist_key(effect_pair.var, effect_pair.value);
+                    state_packer.set(buffer, effect_pair.var, effect_pair.value);
+                }
+            }
+        }
+        return {};
     } else {
         for (EffectProxy effect : op.get_effects()) {
             if (does_fire(effect, predecessor)) {
@@ -106,17 +248,57 @@ State StateRegistry::get_successor_state(const State &predecessor, const Operato
                 state_packer.set(buffer, effect_pair.var, effect_pair.value);
             }
         }
+        return {};
+    }
+}
+
+//TODO it would be nice to move the actual state creation (and operator application)
+//     out of the StateRegistry. This could for example be done by global functions
+//     operating on state buffers (PackedStateBin *).
+State StateRegistry::get_successor_state(const State &predecessor, const OperatorProxy &op) {
+    assert(!op.is_axiom());
+    StateID id = StateID::no_state;
+    vector<int> new_values;
+    if (concurrent) {
+        // Other threads may append to the pool, so we work on a private copy.
+        static thread_local vector<PackedStateBin> buffer;
+        const PackedStateBin *predecessor_buffer = predecessor.get_buffer();
+        buffer.assign(predecessor_buffer, predecessor_buffer + get_stored_bins_per_state());
+        new_values = apply_operator(predecessor, op, buffer.data());
+        id = insert_state_data_concurrently(buffer.data());
+    } else if (storage == StateStorage::TREE_COMPRESSED) {
+        // The states are not stored in place, so we work on a decompressed copy.
+        compressed_state_data->get(predecessor.get_id().value, decompression_buffer.data());
+        new_values = apply_operator(predecessor, op, decompression_buffer.data());
+        id = insert_compressed_state(decompression_buffer.data());
+        if (!task_properties::has_axioms(task_proxy)) {
+            new_values = unpack_state_data(decompression_buffer.data());
+        }
+        return lookup_state(id, std::move(new_values));
+    } else {
+        /*
+          TODO: ideally, we would not modify state_data_pool here and in
+          insert_id_or_pop_state, but only at one place, to avoid errors like
+          buffer becoming a dangling pointer. This used to be a bug before being
+          fixed in https://issues.fast-downward.org/issue1115.
+        */
+        state_data_pool->push_back(predecessor.get_buffer());
+        PackedStateBin *buffer = (*state_data_pool)[state_data_pool->size() - 1];
+        new_values = apply_operator(predecessor, op, buffer);
         /*
           NOTE: insert_id_or_pop_state possibly invalidates buffer, hence
           we use lookup_state to retrieve the state using the correct buffer.
         */
-        StateID id = insert_id_or_pop_state();
-        return lookup_state(id);
+        id = insert_id_or_pop_state();
+    }
+    if (task_properties::has_axioms(task_proxy)) {
+        return lookup_state(id, std::move(new_values));
     }
+    return lookup_state(id);
 }
 
 State StateRegistry::insert_state(const std::vector<int> &state) {
-    int num_bins = get_bins_per_state();
+    int num_bins = get_stored_bins_per_state();
     unique_ptr<PackedStateBin[]> buffer(new PackedStateBin[num_bins]);
     // Avoid garbage values in half-full bins.
     fill_n(buffer.get(), num_bins, 0);
@@ -124,7 +306,13 @@ State StateRegistry::insert_state(const std::vector<int> &state) {
     for (size_t i = 0; i < state.size(); ++i) {
         state_packer.set(buffer.get(), i, state[i]);
     }
-    state_data_pool.push_back(buffer.get());
+    set_stored_hash(buffer.get(), state);
+    if (concurrent) {
+        return lookup_state(insert_state_data_concurrently(buffer.get()));
+    } else if (storage == StateStorage::TREE_COMPRESSED) {
+        return lookup_state(insert_compressed_state(buffer.get()), vector<int>(state));
+    }
+    state_data_pool->push_back(buffer.get());
     StateID id = insert_id_or_pop_state();
     return lookup_state(id);
 }
@@ -133,11 +321,26 @@ int StateRegistry::get_bins_per_state() const {
     return state_packer.get_num_bins();
 }
 
+int StateRegistry::get_stored_bins_per_state() const {
+    return get_bins_per_state() + (hashing == StateHashing::INCREMENTAL ? 1 : 0);
+}
+
 int StateRegistry::get_state_size_in_bytes() const {
-    return get_bins_per_state() * sizeof(PackedStateBin);
+    return get_stored_bins_per_state() * sizeof(PackedStateBin);
 }
 
 void StateRegistry::print_statistics(utils::LogProxy &log) const {
     log << "Number of registered states: " << size() << endl;
-    registered_states.print_statistics(log);
+    if (concurrent) {
+        int max_shard_size = 0;
+        for (int i = 0; i < NUM_SHARDS; ++i) {
+            max_shard_size = max(max_shard_size, shards[i].num_entries);
+        }
+        log << "State registry shards: " << NUM_SHARDS << endl;
+        log << "Largest state registry shard: " << max_shard_size << endl;
+    } else if (storage == StateStorage::TREE_COMPRESSED) {
+        compressed_state_data->print_statistics(log);
+    } else {
+        registered_states->print_statistics(log);
+    }
 }
@@ -5,12 +5,17 @@
 #include "axioms.h"
 #include "state_id.h"
 
+#include "algorithms/concurrent_segmented_vector.h"
 #include "algorithms/int_hash_set.h"
 #include "algorithms/int_packer.h"
 #include "algorithms/segmented_vector.h"
 #include "algorithms/subscriber.h"
+#include "algorithms/tree_compressed_array_set.h"
 #include "utils/hash.h"
 
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <set>
 
 /*
@@ -59,6 +64,25 @@
     while avoiding dynamically allocating each state individually.
     The index within this vector corresponds to the ID of the state.
 
+  Compressed StateRegistry
+    A StateRegistry constructed with StateStorage::TREE_COMPRESSED stores the
+    packed states in a TreeCompressedArraySet instead of a
+    SegmentedArrayVector. States that differ in few bins share most of their
+    storage, which saves a lot of memory in large searches, but states have to
+    be decompressed whenever they are looked up. Such states have no packed
+    data (State::get_buffer) and are always unpacked instead.
+
+  Concurrent StateRegistry
+    A StateRegistry constructed as concurrent can be shared by several threads,
+    e.g., by parallel search, fuzzing or oracles that should work on the same
+    state space. It stores the state data in a ConcurrentSegmentedArrayVector,
+    which can be read while other threads append, and distributes the
+    registered states to lock-protected shards by their hash, so inserting
+    threads only block each other if they insert into the same shard.
+    PerStateInformation can grow alongside a concurrent registry, but accesses
+    to the same entry must still be synchronized by the user. Iterating over
+    the registry is only safe while no thread inserts states.
+
   PerStateInformation<T>
     Associates a value of type T with every state in a given StateRegistry.
     Can be thought of as a very compactly implemented map from State to T.
@@ -111,25 +135,52 @@ class IntPacker;
 
 using PackedStateBin = int_packer::IntPacker::Bin;
 
+static_assert(sizeof(PackedStateBin) == sizeof(int_hash_set::HashType),
+              "incremental state hashing stores the hash in a PackedStateBin");
+
+/*
+  With FULL hashing, the registry hashes all bins of every new state. With
+  INCREMENTAL hashing, it uses Zobrist hashing: the hash of a state is the XOR
+  of random keys of its facts, so the hash of a successor can be derived from
+  the hash of its predecessor and the facts changed by the operator. The hash
+  is stored in an additional bin after the packed state data.
+*/
+enum class StateHashing {
+    FULL,
+    INCREMENTAL
+};
+
+/*
+  With PACKED storage, the registry stores the packed data of every state in
+  place. With TREE_COMPRESSED storage, it uses tree compression (see
+  tree_compressed_array_set.h). Compressed registries identify states by the
+  roots of their trees and hence need no state hashing.
+*/
+enum class StateStorage {
+    PACKED,
+    TREE_COMPRESSED
+};
+
 
 class StateRegistry : public subscriber::SubscriberService<StateRegistry> {
     struct StateIDSemanticHash {
         const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool;
         int state_size;
+        bool use_stored_hash;
         StateIDSemanticHash(
             const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool,
-            int state_size)
+            int state_size, bool use_stored_hash)
             : state_data_pool(state_data_pool),
-              state_size(state_size) {
+              state_size(state_size),
+              use_stored_hash(use_stored_hash) {
         }
 
         int_hash_set::HashType operator()(int id) const {
             const PackedStateBin *data = state_data_pool[id];
-            utils::HashState hash_state;
-            for (int i = 0; i < state_size; ++i) {
-                hash_state.feed(data[i]);
+            if (use_stored_hash) {
+                return data[state_size];
             }
-            return hash_state.get_hash32();
+            return hash_state_data(data, state_size);
         }
     };
 
@@ -157,20 +208,110 @@ class StateRegistry : public subscriber::SubscriberService<StateRegistry> {
     */
     using StateIDSet = int_hash_set::IntHashSet<StateIDSemanticHash, StateIDSemanticEqual>;
 
+    /*
+      Part of the registered states of a concurrent registry: an
+      open-addressing hash table of (hash, ID) pairs protected by its own lock.
+      Storing the hashes avoids comparing state data on most collisions and
+      when rehashing.
+    */
+    struct StateShard {
+        std::mutex mutex;
+        std::vector<std::pair<int_hash_set::HashType, int>> slots;
+        int num_entries = 0;
+    };
+    static const int NUM_SHARDS = 256;
+
     TaskProxy task_proxy;
     const int_packer::IntPacker &state_packer;
     AxiomEvaluator &axiom_evaluator;
     const int num_variables;
 
-    segmented_vector::SegmentedArrayVector<PackedStateBin> state_data_pool;
-    StateIDSet registered_states;
+    const bool concurrent;
+    const StateStorage storage;
+    const StateHashing hashing;
+    // Random keys of all facts for incremental hashing, indexed by
+    // zobrist_offsets[var] + value.
+    std::vector<int_hash_set::HashType> zobrist_keys;
+    std::vector<int> zobrist_offsets;
+
+    // Only constructed for sequential registries.
+    std::optional<segmented_vector::SegmentedArrayVector<PackedStateBin>> state_data_pool;
+    std::optional<StateIDSet> registered_states;
+
+    // Only constructed for registries with compressed storage.
+    std::optional<tree_compression::TreeCompressedArraySet<PackedStateBin>> compressed_state_data;
+    // Reused for decompressing states.
+    mutable std::vector<PackedStateBin> decompression_buffer;
+
+    // Only constructed for concurrent registries.
+    std::optional<segmented_vector::ConcurrentSegmentedArrayVector<PackedStateBin>> concurrent_state_data_pool;
+    std::unique_ptr<StateShard[]> shards;
+    // The axiom evaluator and the initial state cache are not thread-safe.
+    std::mutex axiom_mutex;
+    std::mutex initial_state_mutex;
 
     std::unique_ptr<State> cached_initial_state;
 
+    static int_hash_set::HashType hash_state_data(
+        const PackedStateBin *data, int state_size) {
+        utils::HashState hash_state;
+        for (int i = 0; i < state_size; ++i) {
+            hash_state.feed(data[i]);
+        }
+        return hash_state.get_hash32();
+    }
+
+    const PackedStateBin *get_state_data(StateID id) const {
+        assert(storage == StateStorage::PACKED);
+        if (concurrent) {
+            return (*concurrent_state_data_pool)[id.value];
+        }
+        return (*state_data_pool)[id.value];
+    }
+
+    int_hash_set::HashType get_zobrist_key(int var, int value) const {
+        return zobrist_keys[zobrist_offsets[var] + value];
+    }
+    int_hash_set::HashType compute_zobrist_hash(const std::vector<int> &values) const;
+    // Stores the hash of a state in the additional bin if hashing is incremental.
+    void set_stored_hash(PackedStateBin *buffer, const std::vector<int> &values) const;
+
     StateID insert_id_or_pop_state();
+    // Registers a state of a compressed registry and returns its ID.
+    StateID insert_compressed_state(const PackedStateBin *buffer);
+    std::vector<int> unpack_state_data(const PackedStateBin *buffer) const;
+    /*
+      Concurrent counterpart of insert_id_or_pop_state: registers the given
+      packed state unless it is already registered and returns its ID.
+    */
+    StateID insert_state_data_concurrently(const PackedStateBin *buffer);
+    void grow_shard(StateShard &shard) const;
+    /*
+      Applies the effects of op to buffer, which must hold the packed data of
+      predecessor. For tasks with axioms, returns the unpacked values of the
+      successor, otherwise an empty vector.
+    */
+    std::vector<int> apply_operator(
+        const State &predecessor, const OperatorProxy &op, PackedStateBin *buffer);
     int get_bins_per_state() const;
+    // Includes the bin of the hash if hashing is incremental.
+    int get_stored_bins_per_state() const;
 public:
-    explicit StateRegistry(const TaskProxy &task_proxy);
+    /*
+      A concurrent registry can be used by several threads at the same time
+      (see above). Sequential registries are somewhat faster. Compressed
+      storage is only supported by sequential registries; compressed_leaf_size
+      is the number of bins per leaf of the compression trees.
+    */
+    explicit StateRegistry(
+        const TaskProxy &task_proxy, bool concurrent = false,
+        StateHashing hashing = StateHashing::FULL,
+        StateStorage storage = StateStorage::PACKED,
+        int compressed_leaf_size = 2);
+
+    bool is_concurrent() const {
+        return concurrent;
+    }
 
     const TaskProxy &get_task_proxy() const {
         return task_proxy;
@@ -217,10 +358,17 @@ public:
     State insert_state(const std::vector<int> &state);
 
     /*
-      Returns the number of states registered so far.
+      Returns the number of states registered so far. For concurrent
+      registries, this includes states that other threads are still
+      registering.
     */
     size_t size() const {
-        return registered_states.size();
+        if (concurrent) {
+            return concurrent_state_data_pool->size();
+        } else if (storage == StateStorage::TREE_COMPRESSED) {
+            return compressed_state_data->size();
+        }
+        return registered_states->size();
     }
 
     int get_state_size_in_bytes() const;
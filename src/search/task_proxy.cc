@@ -23,9 +23,13 @@ State::State(const AbstractTask &task, const StateRegistry &registry,
 State::State(const AbstractTask &task, const StateRegistry &registry,
              StateID id, const PackedStateBin *buffer,
              vector<int> &&values)
-    : State(task, registry, id, buffer) {
-    assert(num_variables == static_cast<int>(values.size()));
-    this->values = make_shared<vector<int>>(std::move(values));
+    : task(&task), registry(&registry), id(id), buffer(buffer),
+      values(make_shared<vector<int>>(std::move(values))),
+      state_packer(&registry.get_state_packer()),
+      num_variables(registry.get_num_variables()) {
+    assert(id != StateID::no_state);
+    assert(num_variables == static_cast<int>(this->values->size()));
+    assert(num_variables == task.get_num_variables());
 }
 
 State::State(const AbstractTask &task, vector<int> &&values)
@@ -638,7 +638,11 @@ public:
     // Construct a registered state with only packed data.
     State(const AbstractTask &task, const StateRegistry &registry, StateID id,
           const PackedStateBin *buffer);
-    // Construct a registered state with packed and unpacked data.
+    /*
+      Construct a registered state with packed and unpacked data. Registries
+      that do not store their states in place (see StateStorage) pass
+      nullptr as buffer.
+    */
     State(const AbstractTask &task, const StateRegistry &registry, StateID id,
           const PackedStateBin *buffer, std::vector<int> &&values);
     // Construct a state with only unpacked data.
@@ -676,7 +680,8 @@ public:
 
 
     /* Access the packed values. Accessing packed values on states that do
-       not have them (unregistered states) is an error. */
+       not have them (unregistered states and states of registries with
+       compressed storage) is an error. */
     const PackedStateBin *get_buffer() const;
 
     /*
@@ -908,8 +913,8 @@ inline const PackedStateBin *State::get_buffer() const {
       not costly, but the 'cerr <<' stuff might prevent inlining.
     */
     if (!buffer) {
-        std::cerr << "Accessing the packed values of an unregistered state is "
-                  << "treated as an error."
+        std::cerr << "Accessing the packed values of a state without packed "
+                  << "data is treated as an error."
                   << std::endl;
         utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
     }
@@ -4,15 +4,28 @@
 
 #include "../plugins/plugin.h"
 #include "../utils/collections.h"
+#include "../utils/system.h"
 #include "../utils/timer.h"
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
 #include <memory>
-#include <set>
+#include <streambuf>
+#include <type_traits>
 #include <unordered_set>
 #include <vector>
 
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 
 using namespace std;
 using utils::ExitCode;
@@ -21,6 +34,152 @@ namespace tasks {
 static const int PRE_FILE_VERSION = 3;
 shared_ptr<AbstractTask> g_root_task = nullptr;
 
+/*
+  Binary task format: a header of BINARY_TASK_HEADER_SIZE bytes followed by
+  the payload. The header consists of BINARY_TASK_MAGIC, the format version,
+  a byte-order marker (files are written in native byte order and rejected
+  on machines with a different one), the payload size and the FNV-1a hash of
+  the payload. The payload stores the task as RootTask holds it, i.e., with
+  the operator costs adjusted to the metric, the initial state with axioms
+  evaluated and the mutexes as sorted lists per fact, so loading it only
+  consists of bulk copies. Numbers are stored as 32-bit integers, strings and
+  lists are prefixed by their length.
+*/
+static const char BINARY_TASK_MAGIC[8] = {'\x7f', 'F', 'D', 'R', 'T', 'A', 'S', 'K'};
+static const uint32_t BINARY_TASK_VERSION = 1;
+static const uint32_t BINARY_TASK_BYTE_ORDER = 0x01020304;
+static const size_t BINARY_TASK_HEADER_SIZE = 32;
+
+static_assert(is_trivially_copyable<FactPair>::value && sizeof(FactPair) == 2 * sizeof(int32_t),
+              "the binary task format stores facts as pairs of 32-bit integers");
+
+static uint64_t compute_checksum(string_view data) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c : data) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static void binary_task_error(const string &msg) {
+    cerr << "Invalid binary task: " << msg << endl;
+    utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+}
+
+class BinaryTaskReader {
+    const char *pos;
+    const char *end;
+
+    void check_available(size_t num_bytes) const {
+        if (static_cast<size_t>(end - pos) < num_bytes) {
+            binary_task_error("unexpected end of data");
+        }
+    }
+public:
+    explicit BinaryTaskReader(string_view payload)
+        : pos(payload.data()), end(payload.data() + payload.size()) {
+    }
+
+    template<typename T>
+    T read() {
+        T value;
+        check_available(sizeof(T));
+        memcpy(&value, pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+
+    int read_int() {
+        return read<int32_t>();
+    }
+
+    int read_count() {
+        int count = read_int();
+        if (count < 0) {
+            binary_task_error("negative count");
+        }
+        return count;
+    }
+
+    string read_string() {
+        int length = read_count();
+        check_available(length);
+        string result(pos, length);
+        pos += length;
+        return result;
+    }
+
+    template<typename T>
+    vector<T> read_vector(const T &placeholder) {
+        int count = read_count();
+        check_available(count * sizeof(T));
+        vector<T> result(count, placeholder);
+        memcpy(result.data(), pos, count * sizeof(T));
+        pos += count * sizeof(T);
+        return result;
+    }
+
+    vector<int> read_ints() {
+        return read_vector(0);
+    }
+
+    vector<FactPair> read_facts() {
+        return read_vector(FactPair::no_fact);
+    }
+
+    bool at_end() const {
+        return pos == end;
+    }
+};
+
+class BinaryTaskWriter {
+    string payload;
+public:
+    void write_int(int value) {
+        int32_t value32 = value;
+        payload.append(reinterpret_cast<const char *>(&value32), sizeof(value32));
+    }
+
+    void write_string(const string &str) {
+        write_int(str.size());
+        payload.append(str);
+    }
+
+    template<typename T>
+    void write_vector(const vector<T> &values) {
+        write_int(values.size());
+        payload.append(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+    }
+
+    void write_to(ostream &out) const {
+        uint32_t version = BINARY_TASK_VERSION;
+        uint32_t byte_order = BINARY_TASK_BYTE_ORDER;
+        uint64_t size = payload.size();
+        uint64_t checksum = compute_checksum(payload);
+        out.write(BINARY_TASK_MAGIC, sizeof(BINARY_TASK_MAGIC));
+        out.write(reinterpret_cast<const char *>(&version), sizeof(version));
+        out.write(reinterpret_cast<const char *>(&byte_order), sizeof(byte_order));
+        out.write(reinterpret_cast<const char *>(&size), sizeof(size));
+        out.write(reinterpret_cast<const char *>(&checksum), sizeof(checksum));
+        out.write(payload.data(), payload.size());
+    }
+};
+
+/*
+  Read-only stream buffer over memory owned by someone else, so that text
+  tasks can be parsed from a buffer without copying it. The buffer is never
+  written to: stream buffers only write to their get area in pbackfail(),
+  which we do not override.
+*/
+class MemoryStreamBuffer : public streambuf {
+public:
+    explicit MemoryStreamBuffer(string_view data) {
+        char *begin = const_cast<char *>(data.data());
+        setg(begin, begin, begin + data.size());
+    }
+};
+
 struct ExplicitVariable {
     int domain_size;
     string name;
@@ -29,6 +188,8 @@ struct ExplicitVariable {
     int axiom_default_value;
 
     explicit ExplicitVariable(istream &in);
+    explicit ExplicitVariable(BinaryTaskReader &reader);
+    void write(BinaryTaskWriter &writer) const;
 };
 
 
@@ -49,13 +210,15 @@ struct ExplicitOperator {
 
     void read_pre_post(istream &in);
     ExplicitOperator(istream &in, bool is_an_axiom, bool use_metric);
+    ExplicitOperator(BinaryTaskReader &reader, bool is_an_axiom);
+    void write(BinaryTaskWriter &writer) const;
 };
 
 
 class RootTask : public AbstractTask {
     vector<ExplicitVariable> variables;
-    // TODO: think about using hash sets here.
-    vector<vector<set<FactPair>>> mutexes;
+    // Sorted lists of the facts that are mutex with a given fact.
+    vector<vector<vector<FactPair>>> mutexes;
     vector<ExplicitOperator> operators;
     vector<ExplicitOperator> axioms;
     vector<int> initial_state_values;
@@ -67,6 +230,9 @@ class RootTask : public AbstractTask {
 
 public:
     explicit RootTask(istream &in);
+    explicit RootTask(BinaryTaskReader &reader);
+
+    void write_binary(ostream &out) const;
 
     virtual int get_num_variables() const override;
     virtual string get_variable_name(int var) const override;
@@ -174,6 +340,30 @@ ExplicitVariable::ExplicitVariable(istream &in) {
 }
 
 
+ExplicitVariable::ExplicitVariable(BinaryTaskReader &reader)
+    : domain_size(reader.read_int()),
+      name(reader.read_string()),
+      axiom_layer(reader.read_int()),
+      axiom_default_value(reader.read_int()) {
+    if (domain_size < 1) {
+        binary_task_error("invalid domain size");
+    }
+    fact_names.reserve(domain_size);
+    for (int i = 0; i < domain_size; ++i) {
+        fact_names.push_back(reader.read_string());
+    }
+}
+
+void ExplicitVariable::write(BinaryTaskWriter &writer) const {
+    writer.write_int(domain_size);
+    writer.write_string(name);
+    writer.write_int(axiom_layer);
+    writer.write_int(axiom_default_value);
+    for (const string &fact_name : fact_names) {
+        writer.write_string(fact_name);
+    }
+}
+
 ExplicitEffect::ExplicitEffect(
     int var, int value, vector<FactPair> &&conditions)
     : fact(var, value), conditions(std::move(conditions)) {
@@ -218,6 +408,35 @@ ExplicitOperator::ExplicitOperator(istream &in, bool is_an_axiom, bool use_metri
     assert(cost >= 0);
 }
 
+ExplicitOperator::ExplicitOperator(BinaryTaskReader &reader, bool is_an_axiom)
+    : preconditions(reader.read_facts()),
+      cost(reader.read_int()),
+      name(reader.read_string()),
+      is_an_axiom(is_an_axiom) {
+    int num_effects = reader.read_count();
+    effects.reserve(num_effects);
+    for (int i = 0; i < num_effects; ++i) {
+        int var = reader.read_int();
+        int value = reader.read_int();
+        effects.emplace_back(var, value, reader.read_facts());
+    }
+    if (cost < 0) {
+        binary_task_error("negative operator cost");
+    }
+}
+
+void ExplicitOperator::write(BinaryTaskWriter &writer) const {
+    writer.write_vector(preconditions);
+    writer.write_int(cost);
+    writer.write_string(name);
+    writer.write_int(effects.size());
+    for (const ExplicitEffect &effect : effects) {
+        writer.write_int(effect.fact.var);
+        writer.write_int(effect.fact.value);
+        writer.write_vector(effect.conditions);
+    }
+}
+
 static void read_and_verify_version(istream &in) {
     int version;
     check_magic(in, "begin_version");
@@ -250,8 +469,8 @@ static vector<ExplicitVariable> read_variables(istream &in) {
     return variables;
 }
 
-static vector<vector<set<FactPair>>> read_mutexes(istream &in, const vector<ExplicitVariable> &variables) {
-    vector<vector<set<FactPair>>> inconsistent_facts(variables.size());
+static vector<vector<vector<FactPair>>> read_mutexes(istream &in, const vector<ExplicitVariable> &variables) {
+    vector<vector<vector<FactPair>>> inconsistent_facts(variables.size());
     for (size_t i = 0; i < variables.size(); ++i)
         inconsistent_facts[i].resize(variables[i].domain_size);
 
@@ -260,10 +479,8 @@ static vector<vector<set<FactPair>>> read_mutexes(istream &in, const vector<Expl
 
     /*
       NOTE: Mutex groups can overlap, in which case the same mutex
-      should not be represented multiple times. The current
-      representation takes care of that automatically by using sets.
-      If we ever change this representation, this is something to be
-      aware of.
+      should not be represented multiple times. We remove such
+      duplicates when sorting the lists below.
     */
     for (int i = 0; i < num_mutex_groups; ++i) {
         check_magic(in, "begin_mutex_group");
@@ -291,11 +508,17 @@ static vector<vector<set<FactPair>>> read_mutexes(istream &in, const vector<Expl
                        can of course generate mutex groups which lead
                        to *some* redundant mutexes, where some but not
                        all facts talk about the same variable. */
-                    inconsistent_facts[fact1.var][fact1.value].insert(fact2);
+                    inconsistent_facts[fact1.var][fact1.value].push_back(fact2);
                 }
             }
         }
     }
+    for (vector<vector<FactPair>> &facts_of_var : inconsistent_facts) {
+        for (vector<FactPair> &facts : facts_of_var) {
+            utils::sort_unique(facts);
+            facts.shrink_to_fit();
+        }
+    }
     return inconsistent_facts;
 }
 
@@ -358,6 +581,72 @@ RootTask::RootTask(istream &in) {
     axiom_evaluator.evaluate(initial_state_values);
 }
 
+RootTask::RootTask(BinaryTaskReader &reader) {
+    int num_variables = reader.read_count();
+    variables.reserve(num_variables);
+    for (int i = 0; i < num_variables; ++i) {
+        variables.emplace_back(reader);
+    }
+    mutexes.resize(num_variables);
+    for (int var = 0; var < num_variables; ++var) {
+        mutexes[var].reserve(variables[var].domain_size);
+        for (int value = 0; value < variables[var].domain_size; ++value) {
+            mutexes[var].push_back(reader.read_facts());
+            check_facts(mutexes[var].back(), variables);
+        }
+    }
+    // The initial state is stored with evaluated axioms.
+    initial_state_values = reader.read_ints();
+    if (static_cast<int>(initial_state_values.size()) != num_variables) {
+        binary_task_error("wrong size of the initial state");
+    }
+    goals = reader.read_facts();
+    if (goals.empty()) {
+        cerr << "Task has no goal condition!" << endl;
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+    check_facts(goals, variables);
+    int num_operators = reader.read_count();
+    operators.reserve(num_operators);
+    for (int i = 0; i < num_operators; ++i) {
+        operators.emplace_back(reader, false);
+        check_facts(operators.back(), variables);
+    }
+    int num_axioms = reader.read_count();
+    axioms.reserve(num_axioms);
+    for (int i = 0; i < num_axioms; ++i) {
+        axioms.emplace_back(reader, true);
+        check_facts(axioms.back(), variables);
+    }
+    if (!reader.at_end()) {
+        binary_task_error("unexpected data after the task");
+    }
+}
+
+void RootTask::write_binary(ostream &out) const {
+    BinaryTaskWriter writer;
+    writer.write_int(variables.size());
+    for (const ExplicitVariable &var : variables) {
+        var.write(writer);
+    }
+    for (const vector<vector<FactPair>> &facts_of_var : mutexes) {
+        for (const vector<FactPair> &facts : facts_of_var) {
+            writer.write_vector(facts);
+        }
+    }
+    writer.write_vector(initial_state_values);
+    writer.write_vector(goals);
+    writer.write_int(operators.size());
+    for (const ExplicitOperator &op : operators) {
+        op.write(writer);
+    }
+    writer.write_int(axioms.size());
+    for (const ExplicitOperator &axiom : axioms) {
+        axiom.write(writer);
+    }
+    writer.write_to(out);
+}
+
 const ExplicitVariable &RootTask::get_variable(int var) const {
     assert(utils::in_bounds(var, variables));
     return variables[var];
@@ -413,7 +702,8 @@ bool RootTask::are_facts_mutex(const FactPair &fact1, const FactPair &fact2) con
     }
     assert(utils::in_bounds(fact1.var, mutexes));
     assert(utils::in_bounds(fact1.value, mutexes[fact1.var]));
-    return bool(mutexes[fact1.var][fact1.value].count(fact2));
+    const vector<FactPair> &facts = mutexes[fact1.var][fact1.value];
+    return binary_search(facts.begin(), facts.end(), fact2);
 }
 
 int RootTask::get_operator_cost(int index, bool is_axiom) const {
@@ -492,9 +782,96 @@ void RootTask::convert_ancestor_state_values(
     }
 }
 
+static bool is_binary_task(string_view data) {
+    return data.size() >= sizeof(BINARY_TASK_MAGIC) &&
+           equal(begin(BINARY_TASK_MAGIC), end(BINARY_TASK_MAGIC), data.begin());
+}
+
+static void read_binary_root_task(string_view data) {
+    assert(is_binary_task(data));
+    if (data.size() < BINARY_TASK_HEADER_SIZE) {
+        binary_task_error("incomplete header");
+    }
+    BinaryTaskReader header(data.substr(sizeof(BINARY_TASK_MAGIC), BINARY_TASK_HEADER_SIZE - sizeof(BINARY_TASK_MAGIC)));
+    uint32_t version = header.read<uint32_t>();
+    uint32_t byte_order = header.read<uint32_t>();
+    uint64_t size = header.read<uint64_t>();
+    uint64_t checksum = header.read<uint64_t>();
+    if (version != BINARY_TASK_VERSION) {
+        cerr << "Expected binary task version " << BINARY_TASK_VERSION
+             << ", got " << version << "." << endl;
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+    if (byte_order != BINARY_TASK_BYTE_ORDER) {
+        binary_task_error("written on a machine with a different byte order");
+    }
+    string_view payload = data.substr(BINARY_TASK_HEADER_SIZE);
+    if (payload.size() != size) {
+        binary_task_error("expected " + to_string(size) + " bytes of data, got "
+                          + to_string(payload.size()));
+    }
+    if (compute_checksum(payload) != checksum) {
+        binary_task_error("checksum mismatch");
+    }
+    BinaryTaskReader reader(payload);
+    g_root_task = make_shared<RootTask>(reader);
+}
+
 void read_root_task(istream &in) {
     assert(!g_root_task);
-    g_root_task = make_shared<RootTask>(in);
+    if (in.peek() == BINARY_TASK_MAGIC[0]) {
+        string data((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+        read_root_task_from_buffer(data);
+    } else {
+        g_root_task = make_shared<RootTask>(in);
+    }
+}
+
+void read_root_task_from_buffer(string_view data) {
+    assert(!g_root_task);
+    if (is_binary_task(data)) {
+        read_binary_root_task(data);
+    } else {
+        MemoryStreamBuffer buffer(data);
+        istream in(&buffer);
+        g_root_task = make_shared<RootTask>(in);
+    }
+}
+
+void read_root_task_from_file(const string &path) {
+    assert(!g_root_task);
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+    int fd = open(path.c_str(), O_RDONLY);
+    struct stat file_stat;
+    if (fd >= 0 && fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+        size_t size = file_stat.st_size;
+        void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (data != MAP_FAILED) {
+            string_view contents(static_cast<const char *>(data), size);
+            if (is_binary_task(contents)) {
+                read_binary_root_task(contents);
+                munmap(data, size);
+                return;
+            }
+            munmap(data, size);
+        }
+    } else if (fd >= 0) {
+        close(fd);
+    }
+#endif
+    ifstream in(path, ios::binary);
+    if (!in) {
+        cerr << "Cannot open " << path << endl;
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+    read_root_task(in);
+}
+
+void write_binary_root_task(ostream &out) {
+    const RootTask *root_task = dynamic_cast<const RootTask *>(g_root_task.get());
+    assert(root_task);
+    root_task->write_binary(out);
 }
 
 class RootTaskFeature : public plugins::TypedFeature<AbstractTask, AbstractTask> {
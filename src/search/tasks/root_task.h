@@ -3,8 +3,21 @@
 
 #include "../abstract_task.h"
 
+#include <string>
+#include <string_view>
+
 namespace tasks {
 extern std::shared_ptr<AbstractTask> g_root_task;
+/*
+  The root task can be read in the text format written by the translator or
+  in the binary format written by write_binary_root_task, which is much
+  faster to load for large tasks. The format is detected automatically.
+*/
 extern void read_root_task(std::istream &in);
+// Memory-maps the file where supported.
+extern void read_root_task_from_file(const std::string &path);
+// E.g., for tasks received from a policy server.
+extern void read_root_task_from_buffer(std::string_view data);
+extern void write_binary_root_task(std::ostream &out);
 }
 #endif
@@ -0,0 +1,56 @@
+#!/usr/bin/env python3
+
+"""
+Writes the test tasks in the binary task format, checks that searching on the binary task behaves exactly like
+searching on the translator output and that corrupted binary tasks are rejected.
+"""
+
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+SEARCH_INPUT_ERROR = 33
+
+engine, tasks_dir = sys.argv[1:]
+
+
+def run(args, input_file, cwd):
+    with open(input_file, 'rb') as stdin:
+        return subprocess.run([engine] + args + ['--search', 'astar(blind())'], stdin=stdin, cwd=cwd,
+                              capture_output=True)
+
+
+def search_result(output):
+    # everything that must not depend on the input format
+    return re.findall(r'^(?:Plan length|Plan cost|Expanded|Generated) .*$', output.decode(), re.MULTILINE)
+
+
+failed = False
+with tempfile.TemporaryDirectory() as tmp_dir:
+    for name in sorted(os.listdir(tasks_dir)):
+        task = os.path.join(tasks_dir, name)
+        binary_task = os.path.join(tmp_dir, name + '.bin')
+        text_run = run(['--write-binary-task', binary_task], task, tmp_dir)
+        binary_run = run([], binary_task, tmp_dir)
+        if text_run.returncode != binary_run.returncode or \
+                search_result(text_run.stdout) != search_result(binary_run.stdout):
+            print(f'{name}: search on binary task differs from search on text task')
+            print(binary_run.stdout.decode(), binary_run.stderr.decode())
+            failed = True
+            continue
+
+        with open(binary_task, 'rb') as f:
+            data = bytearray(f.read())
+        data[-1] ^= 1
+        with open(binary_task, 'wb') as f:
+            f.write(data)
+        corrupted_run = run([], binary_task, tmp_dir)
+        if corrupted_run.returncode != SEARCH_INPUT_ERROR or b'checksum mismatch' not in corrupted_run.stderr:
+            print(f'{name}: corrupted binary task was not rejected (exit code {corrupted_run.returncode})')
+            failed = True
+            continue
+        print(f'{name}: ok')
+
+sys.exit(1 if failed else 0)
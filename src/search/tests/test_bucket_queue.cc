@@ -0,0 +1,94 @@
+#include "../algorithms/bucket_queue.h"
+#include "../utils/rng.h"
+
+#include <deque>
+#include <iostream>
+#include <map>
+#include <vector>
+
+using namespace std;
+
+/*
+  Performs random insertions and removals on bucket queues and on maps from
+  keys to deques, which is how the tie-breaking open list stores its
+  entries, and checks that both return the same values in the same order.
+  The scenarios cover monotone keys (as in A*), non-monotone keys, several
+  key components and keys large enough to make the levels sparse.
+*/
+
+static const int NUM_OPERATIONS = 200000;
+
+struct Scenario {
+    int dimension;
+    int max_key;
+    int max_dense_key;
+    // Keys of insertions are at least the last removed first component minus this.
+    int max_decrease;
+};
+
+static bool run(const Scenario &scenario, utils::RandomNumberGenerator &rng) {
+    bucket_queue::BucketQueue<int> queue(scenario.dimension, scenario.max_dense_key);
+    map<vector<int>, deque<int>> reference;
+    int reference_size = 0;
+    int last_removed = 0;
+    vector<int> key(scenario.dimension);
+    for (int i = 0; i < NUM_OPERATIONS; ++i) {
+        if (reference_size == 0 || rng.random(100) < 55) {
+            int lowest = max(0, last_removed - scenario.max_decrease);
+            key[0] = lowest + rng.random(max(1, scenario.max_key - lowest));
+            for (int j = 1; j < scenario.dimension; ++j) {
+                key[j] = rng.random(scenario.max_key);
+            }
+            queue.push(key, i);
+            reference[key].push_back(i);
+            ++reference_size;
+        } else {
+            auto it = reference.begin();
+            int expected = it->second.front();
+            last_removed = it->first[0];
+            it->second.pop_front();
+            if (it->second.empty()) {
+                reference.erase(it);
+            }
+            --reference_size;
+            int value = queue.pop();
+            if (value != expected) {
+                cerr << "Expected " << expected << " but got " << value << endl;
+                return false;
+            }
+        }
+        if (queue.size() != reference_size) {
+            cerr << "Wrong size " << queue.size() << " instead of " << reference_size << endl;
+            return false;
+        }
+        if (rng.random(NUM_OPERATIONS / 4) == 0) {
+            queue.clear();
+            reference.clear();
+            reference_size = 0;
+        }
+    }
+    return true;
+}
+
+int main() {
+    vector<Scenario> scenarios = {
+        {1, 100, 4096, 0},
+        {1, 100, 4096, 50},
+        {2, 50, 4096, 0},
+        {2, 50, 4096, 20},
+        {3, 10, 4096, 5},
+        {1, 1000000, 4096, 0},
+        {1, 1000000, 4096, 500000},
+        {2, 100, 16, 0},
+        {2, 100, 16, 40},
+    };
+    utils::RandomNumberGenerator rng(2024);
+    for (size_t i = 0; i < scenarios.size(); ++i) {
+        if (!run(scenarios[i], rng)) {
+            cerr << "Scenario " << i << " failed" << endl;
+            return 1;
+        }
+    }
+    cout << "Checked " << scenarios.size() << " scenarios" << endl;
+    return 0;
+}
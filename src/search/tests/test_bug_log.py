@@ -0,0 +1,57 @@
+#!/usr/bin/env python3
+
+"""
+Fuzzes the test tasks with a bug log, re-tests the logged bug states with pool_policy_tester and checks that the
+log holds every bug found by the fuzzer and that all of them are found again. The planner exits without destroying
+the engine, so this also checks that the log reaches the disk.
+"""
+
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+engine, tasks_dir = sys.argv[1:]
+TASKS = ['gripper1.sas', 'spanner1.sas', 'visitall1.sas']
+# blind descent runs into dead ends and takes detours, so the fuzzer finds bugs
+POLICY = 'heuristic_descend_policy(eval=blind(), steps_limit=4)'
+ORACLE = 'estimator_based_oracle(oracle=internal_planner_plan_cost_estimator(conf=astar_lmcut))'
+
+
+def run(search, task, cwd):
+    with open(task, 'rb') as stdin:
+        result = subprocess.run([engine, '--search', search], stdin=stdin, cwd=cwd, capture_output=True)
+    return result.stdout.decode() + result.stderr.decode()
+
+
+def count(pattern, output):
+    match = re.search(pattern, output, re.MULTILINE)
+    return int(match.group(1)) if match else None
+
+
+failed = False
+total_bugs = 0
+with tempfile.TemporaryDirectory() as tmp_dir:
+    for name in TASKS:
+        task = os.path.join(tasks_dir, name)
+        bug_log = os.path.join(tmp_dir, name + '.log')
+        fuzzing_output = run(f'pool_fuzzer(policy={POLICY}, testing_method={ORACLE}, max_steps=50, '
+                             f'bug_log="{bug_log}")', task, tmp_dir)
+        retest_output = run(f'pool_policy_tester(policy={POLICY}, testing_method={ORACLE}, '
+                            f'retest_bug_log="{bug_log}")', task, tmp_dir)
+        bugs = count(r'^Bugs found: (\d+)$', fuzzing_output)
+        loaded = count(r'^\.\.\. loaded (\d+) bug states$', retest_output)
+        retested_bugs = count(r'^Bugs found: (\d+)$', retest_output)
+        if bugs is None or bugs != loaded or loaded != retested_bugs:
+            print(f'{name}: fuzzer found {bugs} bugs, {loaded} were logged and {retested_bugs} found again')
+            print(fuzzing_output, retest_output)
+            failed = True
+            continue
+        total_bugs += bugs
+        print(f'{name}: ok ({bugs} bugs)')
+
+if total_bugs == 0:
+    print('no bugs found, so the bug log was not tested')
+    failed = True
+sys.exit(1 if failed else 0)
@@ -0,0 +1,95 @@
+#include "test_utils.h"
+
+#include "../state_registry.h"
+#include "../task_proxy.h"
+
+#include "../tasks/root_task.h"
+
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+/*
+  Explores the state space of a task breadth-first with packed and with
+  tree-compressed state storage for several leaf sizes and checks that all
+  registries register the same states in the same order, that looking up a
+  state returns its values and that inserting a registered state again
+  returns its ID. Afterwards, random (possibly unreachable) states are
+  inserted to cover states that share few tree nodes.
+*/
+
+static const int MAX_EXPANSIONS = 20000;
+static const int NUM_RANDOM_STATES = 20000;
+
+static bool explore(StateRegistry &registry, vector<vector<int>> &states_by_id) {
+    State initial_state = registry.get_initial_state();
+    initial_state.unpack();
+    states_by_id.push_back(initial_state.get_unpacked_values());
+    test_utils::explore_breadth_first(
+        registry, MAX_EXPANSIONS,
+        [&](const State &, const vector<State> &, const vector<State> &new_successors) {
+            for (const State &successor : new_successors) {
+                states_by_id.push_back(successor.get_unpacked_values());
+            }
+            return true;
+        });
+
+    for (const vector<int> &values : test_utils::create_random_states(
+             registry.get_task_proxy(), NUM_RANDOM_STATES)) {
+        size_t num_registered = registry.size();
+        registry.insert_state(values);
+        if (registry.size() > num_registered) {
+            states_by_id.push_back(values);
+        }
+    }
+
+    if (states_by_id.size() != registry.size()) {
+        cerr << "Registry size differs from number of new states" << endl;
+        return false;
+    }
+    // The registry iterates over the states in the order of their IDs.
+    size_t index = 0;
+    for (StateID id : registry) {
+        State state = registry.lookup_state(id);
+        state.unpack();
+        if (state.get_unpacked_values() != states_by_id[index++]) {
+            cerr << "State " << id << " has the wrong values" << endl;
+            return false;
+        }
+        if (registry.insert_state(state.get_unpacked_values()).get_id() != id) {
+            cerr << "Registering state " << id << " again gives a different ID" << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    if (!test_utils::read_root_task_from_arguments(argc, argv)) {
+        return 2;
+    }
+    TaskProxy task_proxy(*tasks::g_root_task);
+
+    vector<vector<int>> states_with_packed_storage;
+    StateRegistry packed_registry(task_proxy);
+    if (!explore(packed_registry, states_with_packed_storage)) {
+        return 1;
+    }
+    for (int leaf_size : {1, 2, 3, 1000}) {
+        vector<vector<int>> states_with_compressed_storage;
+        StateRegistry compressed_registry(
+            task_proxy, false, StateHashing::FULL,
+            StateStorage::TREE_COMPRESSED, leaf_size);
+        if (!explore(compressed_registry, states_with_compressed_storage)) {
+            return 1;
+        }
+        if (states_with_compressed_storage != states_with_packed_storage) {
+            cerr << "Registries with packed and compressed storage (leaf size "
+                 << leaf_size << ") differ" << endl;
+            return 1;
+        }
+    }
+    cout << "Registered " << packed_registry.size() << " states" << endl;
+    return 0;
+}
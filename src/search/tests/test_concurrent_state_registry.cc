@@ -0,0 +1,145 @@
+#include "test_utils.h"
+
+#include "../per_state_information.h"
+#include "../state_registry.h"
+#include "../task_proxy.h"
+
+#include "../task_utils/successor_generator.h"
+#include "../tasks/root_task.h"
+#include "../utils/rng.h"
+
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/*
+  Lets several threads explore the state space of a task through one shared
+  concurrent StateRegistry and checks that all threads agree on the IDs of
+  the states, that different states get different IDs and that every
+  registered state was generated by some thread (i.e., no duplicates were
+  registered). The threads apply the operators in different random orders, so
+  they insert partly the same and partly different states at the same time.
+  Since the reachable state spaces of the test tasks are small, the threads
+  additionally insert a shared set of random (possibly unreachable) states in
+  different orders.
+*/
+
+static const int NUM_THREADS = 8;
+static const int MAX_EXPANSIONS_PER_THREAD = 5000;
+static const int NUM_RANDOM_STATES = 100000;
+
+using StateIDsByValues = map<vector<int>, StateID>;
+
+// Each state's per-state information is written by one thread only.
+static int get_owner(const vector<int> &values) {
+    return accumulate(values.begin(), values.end(), 0) % NUM_THREADS;
+}
+
+static void explore(StateRegistry &registry, PerStateInformation<StateID> &owner_ids,
+                    int thread_id, StateIDsByValues &generated) {
+    utils::RandomNumberGenerator rng(thread_id);
+    test_utils::explore_breadth_first(
+        registry, MAX_EXPANSIONS_PER_THREAD,
+        [&](const State &, const vector<State> &successors, const vector<State> &) {
+            for (const State &successor : successors) {
+                const vector<int> &values = successor.get_unpacked_values();
+                generated.emplace(values, successor.get_id());
+                if (get_owner(values) == thread_id) {
+                    owner_ids[successor] = successor.get_id();
+                }
+            }
+            return true;
+        },
+        &rng);
+}
+
+static void insert_random_states(
+    StateRegistry &registry, const vector<vector<int>> &random_states,
+    int thread_id, StateIDsByValues &generated) {
+    vector<int> order(random_states.size());
+    iota(order.begin(), order.end(), 0);
+    utils::RandomNumberGenerator rng(thread_id);
+    rng.shuffle(order);
+    for (int i : order) {
+        State state = registry.insert_state(random_states[i]);
+        generated.emplace(random_states[i], state.get_id());
+    }
+}
+
+static bool check(const StateRegistry &registry, const PerStateInformation<StateID> &owner_ids,
+                  const vector<StateIDsByValues> &generated_by_thread) {
+    StateIDsByValues all_generated;
+    for (const StateIDsByValues &generated : generated_by_thread) {
+        for (const auto &[values, id] : generated) {
+            auto [it, inserted] = all_generated.emplace(values, id);
+            if (!inserted && it->second != id) {
+                cerr << "Threads disagree on the ID of a state: "
+                     << it->second << " vs. " << id << endl;
+                return false;
+            }
+        }
+    }
+    set<StateID> ids;
+    for (const auto &[values, id] : all_generated) {
+        if (!ids.insert(id).second) {
+            cerr << "Two different states have ID " << id << endl;
+            return false;
+        }
+        State state = registry.lookup_state(id);
+        state.unpack();
+        if (state.get_unpacked_values() != values) {
+            cerr << "State " << id << " has the wrong data" << endl;
+            return false;
+        }
+        StateID owner_id = owner_ids[state];
+        if (owner_id != StateID::no_state && owner_id != id) {
+            cerr << "Wrong per-state information for state " << id << endl;
+            return false;
+        }
+    }
+    // Registering a state twice would leave one of its IDs unused.
+    StateID initial_state_id = registry.lookup_state(*registry.begin()).get_id();
+    for (StateID id : registry) {
+        // The initial state is the only registered state that need not be generated.
+        if (!ids.count(id) && id != initial_state_id) {
+            cerr << "State " << id << " was registered but never generated" << endl;
+            return false;
+        }
+    }
+    cout << "Registered " << registry.size() << " states with "
+         << NUM_THREADS << " threads" << endl;
+    return true;
+}
+
+int main(int argc, char **argv) {
+    if (!test_utils::read_root_task_from_arguments(argc, argv)) {
+        return 2;
+    }
+    TaskProxy task_proxy(*tasks::g_root_task);
+    // Per-task caches are not thread-safe, so we create them up front.
+    successor_generator::g_successor_generators[task_proxy];
+
+    vector<vector<int>> random_states = test_utils::create_random_states(
+        task_proxy, NUM_RANDOM_STATES, NUM_THREADS);
+
+    StateRegistry registry(task_proxy, true);
+    PerStateInformation<StateID> owner_ids(StateID::no_state);
+    vector<StateIDsByValues> generated_by_thread(NUM_THREADS);
+    vector<thread> threads;
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        threads.emplace_back(
+            [&, i]() {
+                explore(registry, owner_ids, i, generated_by_thread[i]);
+                insert_random_states(registry, random_states, i, generated_by_thread[i]);
+            });
+    }
+    for (thread &t : threads) {
+        t.join();
+    }
+    return check(registry, owner_ids, generated_by_thread) ? 0 : 1;
+}
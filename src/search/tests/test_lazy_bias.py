@@ -0,0 +1,50 @@
+#!/usr/bin/env python3
+
+"""
+Fuzzes the test tasks with lazy bias computation and reports for how many successor candidates the bias was computed.
+Checks that the bias estimates skip the bias computation for a part of the candidates.
+"""
+
+import os
+import re
+import subprocess
+import sys
+
+engine, tasks_dir = sys.argv[1:]
+TASKS = ['gripper1.sas', 'spanner1.sas', 'transport1.sas', 'satellite1.sas']
+POLICY = 'heuristic_descend_policy(eval=blind(), steps_limit=4)'
+BIASES = [f'detour_bias(policy={POLICY}, h=hmax())', f'loopiness_bias(policy={POLICY}, h=hmax())']
+ORACLE = 'estimator_based_oracle(oracle=internal_planner_plan_cost_estimator(conf=astar_lmcut))'
+
+
+def count(pattern, output):
+    match = re.search(pattern, output, re.MULTILINE)
+    return int(match.group(1)) if match else None
+
+
+failed = False
+total_candidates = 0
+total_computations = 0
+for name in TASKS:
+    for bias in BIASES:
+        search = f'pool_fuzzer(policy={POLICY}, testing_method={ORACLE}, max_steps=200, lazy_bias=true, bias={bias})'
+        with open(os.path.join(tasks_dir, name), 'rb') as stdin:
+            result = subprocess.run([engine, '--search', search], stdin=stdin, capture_output=True)
+        output = result.stdout.decode() + result.stderr.decode()
+        candidates = count(r'^Lazy bias candidates: (\d+)$', output)
+        computations = count(r'^Lazy bias computations: (\d+)$', output)
+        bias_name = bias.split('(')[0]
+        if candidates is None or computations is None:
+            print(f'{name}, {bias_name}: no lazy bias statistics')
+            print(output)
+            failed = True
+            continue
+        total_candidates += candidates
+        total_computations += computations
+        print(f'{name}, {bias_name}: bias computed for {computations} of {candidates} candidates')
+
+print(f'total: bias computed for {total_computations} of {total_candidates} candidates')
+if total_computations >= total_candidates:
+    print('the bias estimates did not save any bias computation')
+    failed = True
+sys.exit(1 if failed else 0)
@@ -0,0 +1,89 @@
+#include "test_utils.h"
+
+#include "../state_registry.h"
+#include "../task_proxy.h"
+
+#include "../heuristics/max_heuristic.h"
+#include "../plugins/options.h"
+#include "../tasks/root_task.h"
+#include "../utils/logging.h"
+
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+/*
+  Checks that h^max computes the same estimates for batches of states as
+  for single states. For tasks with unit costs, batches are evaluated with
+  a bit-parallel exploration. The batches are the successors of states
+  explored breadth-first and groups of random (possibly unreachable)
+  states that span several blocks of 64 states.
+*/
+
+static const int MAX_EXPANSIONS = 2000;
+static const int NUM_RANDOM_BATCHES = 20;
+static const int RANDOM_BATCH_SIZE = 150;
+
+static shared_ptr<max_heuristic::HSPMaxHeuristic> create_hmax() {
+    plugins::Options opts;
+    opts.set<shared_ptr<AbstractTask>>("transform", tasks::g_root_task);
+    opts.set<bool>("cache_estimates", false);
+    opts.set<utils::Verbosity>("verbosity", utils::Verbosity::SILENT);
+    return make_shared<max_heuristic::HSPMaxHeuristic>(opts);
+}
+
+static bool compare(max_heuristic::HSPMaxHeuristic &batch_hmax,
+                    max_heuristic::HSPMaxHeuristic &single_hmax,
+                    const State &parent, const vector<State> &states) {
+    vector<int> batch_values;
+    batch_hmax.compute_successor_values(parent, states, batch_values);
+    vector<int> single_values;
+    for (size_t i = 0; i < states.size(); ++i) {
+        single_hmax.compute_successor_values(parent, {states[i]}, single_values);
+        if (batch_values[i] != single_values[0]) {
+            cerr << "State " << states[i].get_id() << " has h^max "
+                 << single_values[0] << " but " << batch_values[i]
+                 << " in a batch of " << states.size() << " states" << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    if (!test_utils::read_root_task_from_arguments(argc, argv)) {
+        return 2;
+    }
+    TaskProxy task_proxy(*tasks::g_root_task);
+    shared_ptr<max_heuristic::HSPMaxHeuristic> batch_hmax = create_hmax();
+    shared_ptr<max_heuristic::HSPMaxHeuristic> single_hmax = create_hmax();
+
+    StateRegistry registry(task_proxy);
+    int num_batches = 0;
+    if (!test_utils::explore_breadth_first(
+            registry, MAX_EXPANSIONS,
+            [&](const State &state, const vector<State> &successors, const vector<State> &) {
+                ++num_batches;
+                return compare(*batch_hmax, *single_hmax, state, successors);
+            })) {
+        return 1;
+    }
+
+    State initial_state = registry.get_initial_state();
+    vector<vector<int>> random_states = test_utils::create_random_states(
+        task_proxy, NUM_RANDOM_BATCHES * RANDOM_BATCH_SIZE);
+    for (int batch = 0; batch < NUM_RANDOM_BATCHES; ++batch) {
+        vector<State> states;
+        for (int i = 0; i < RANDOM_BATCH_SIZE; ++i) {
+            states.push_back(registry.insert_state(random_states[batch * RANDOM_BATCH_SIZE + i]));
+        }
+        if (!compare(*batch_hmax, *single_hmax, initial_state, states)) {
+            return 1;
+        }
+        ++num_batches;
+    }
+    cout << "Compared " << num_batches << " batches" << endl;
+    return 0;
+}
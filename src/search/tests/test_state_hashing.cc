@@ -0,0 +1,66 @@
+#include "test_utils.h"
+
+#include "../state_registry.h"
+#include "../task_proxy.h"
+
+#include "../tasks/root_task.h"
+
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+/*
+  Explores the state space of a task breadth-first with full and with
+  incremental state hashing and checks that both registries assign the same
+  IDs to the same states. Inserting every generated state once more from its
+  values (which hashes it from scratch) must return the ID it was registered
+  with; otherwise the incrementally derived hash differed from the hash of the
+  state data and the state was registered twice.
+*/
+
+static const int MAX_EXPANSIONS = 20000;
+
+static bool explore(StateRegistry &registry, vector<vector<int>> &states_by_id) {
+    return test_utils::explore_breadth_first(
+        registry, MAX_EXPANSIONS,
+        [&](const State &, const vector<State> &successors, const vector<State> &new_successors) {
+            for (const State &successor : successors) {
+                if (registry.insert_state(successor.get_unpacked_values()).get_id() != successor.get_id()) {
+                    cerr << "Registering state " << successor.get_id()
+                         << " from its values gives a different ID" << endl;
+                    return false;
+                }
+            }
+            for (const State &successor : new_successors) {
+                states_by_id.push_back(successor.get_unpacked_values());
+            }
+            return true;
+        });
+}
+
+int main(int argc, char **argv) {
+    if (!test_utils::read_root_task_from_arguments(argc, argv)) {
+        return 2;
+    }
+    TaskProxy task_proxy(*tasks::g_root_task);
+
+    vector<vector<int>> states_with_full_hashing;
+    vector<vector<int>> states_with_incremental_hashing;
+    vector<vector<int>> states_with_concurrent_incremental_hashing;
+    StateRegistry full_registry(task_proxy, false, StateHashing::FULL);
+    StateRegistry incremental_registry(task_proxy, false, StateHashing::INCREMENTAL);
+    StateRegistry concurrent_registry(task_proxy, true, StateHashing::INCREMENTAL);
+    if (!explore(full_registry, states_with_full_hashing) ||
+        !explore(incremental_registry, states_with_incremental_hashing) ||
+        !explore(concurrent_registry, states_with_concurrent_incremental_hashing)) {
+        return 1;
+    }
+    if (states_with_incremental_hashing != states_with_full_hashing ||
+        states_with_concurrent_incremental_hashing != states_with_full_hashing) {
+        cerr << "Registries with full and incremental hashing differ" << endl;
+        return 1;
+    }
+    cout << "Registered " << full_registry.size() << " states" << endl;
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include "test_utils.h"
+
+#include "../state_registry.h"
+#include "../task_proxy.h"
+
+#include "../task_utils/successor_generator.h"
+#include "../tasks/root_task.h"
+#include "../utils/hash.h"
+#include "../utils/rng.h"
+
+#include <deque>
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+
+namespace test_utils {
+bool read_root_task_from_arguments(int argc, char **argv) {
+    if (argc != 2) {
+        cerr << "usage: " << argv[0] << " <output.sas>" << endl;
+        return false;
+    }
+    ifstream task_file(argv[1]);
+    if (!task_file) {
+        cerr << "Could not open " << argv[1] << endl;
+        return false;
+    }
+    tasks::read_root_task(task_file);
+    return true;
+}
+
+bool explore_breadth_first(
+    StateRegistry &registry, int max_expansions,
+    const ExpansionCallback &expand, utils::RandomNumberGenerator *rng) {
+    const TaskProxy &task_proxy = registry.get_task_proxy();
+    const successor_generator::SuccessorGenerator &successor_generator =
+        successor_generator::g_successor_generators[task_proxy];
+    OperatorsProxy operators = task_proxy.get_operators();
+    utils::HashSet<StateID> closed;
+    deque<StateID> open;
+    StateID initial_state_id = registry.get_initial_state().get_id();
+    closed.insert(initial_state_id);
+    open.push_back(initial_state_id);
+    vector<OperatorID> applicable_ops;
+    vector<State> successors;
+    vector<State> new_successors;
+    for (int expansions = 0; !open.empty() && expansions < max_expansions; ++expansions) {
+        State state = registry.lookup_state(open.front());
+        open.pop_front();
+        applicable_ops.clear();
+        successor_generator.generate_applicable_ops(state, applicable_ops);
+        if (rng) {
+            rng->shuffle(applicable_ops);
+        }
+        successors.clear();
+        new_successors.clear();
+        for (OperatorID op_id : applicable_ops) {
+            State successor = registry.get_successor_state(state, operators[op_id]);
+            successor.unpack();
+            if (closed.insert(successor.get_id()).second) {
+                open.push_back(successor.get_id());
+                new_successors.push_back(successor);
+            }
+            successors.push_back(move(successor));
+        }
+        if (!expand(state, successors, new_successors)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+vector<vector<int>> create_random_states(
+    const TaskProxy &task_proxy, int num_states, int seed) {
+    utils::RandomNumberGenerator rng(seed);
+    VariablesProxy variables = task_proxy.get_variables();
+    vector<vector<int>> random_states(num_states, vector<int>(variables.size()));
+    for (vector<int> &values : random_states) {
+        for (VariableProxy var : variables) {
+            values[var.get_id()] = rng.random(var.get_domain_size());
+        }
+    }
+    return random_states;
+}
+}
@@ -0,0 +1,51 @@
+#ifndef TESTS_TEST_UTILS_H
+#define TESTS_TEST_UTILS_H
+
+#include <functional>
+#include <vector>
+
+class State;
+class StateRegistry;
+class TaskProxy;
+
+namespace utils {
+class RandomNumberGenerator;
+}
+
+/*
+  Scaffolding shared by the unit tests: reading the task, exploring its state
+  space and drawing random states.
+*/
+namespace test_utils {
+/*
+  Reads the root task from the file given as the only command line argument.
+  Prints the usage or the error and returns false if this fails.
+*/
+extern bool read_root_task_from_arguments(int argc, char **argv);
+
+/*
+  Called for every expanded state with all its successors (in the order in
+  which the operators were applied) and those of them that were generated for
+  the first time. Returning false stops the exploration.
+*/
+using ExpansionCallback = std::function<bool(
+    const State &state, const std::vector<State> &successors,
+    const std::vector<State> &new_successors)>;
+
+/*
+  Explores the state space breadth-first from the initial state through the
+  given registry for at most max_expansions expansions. If rng is given, the
+  applicable operators of each state are applied in a random order. Returns
+  false iff the callback stopped the exploration.
+*/
+extern bool explore_breadth_first(
+    StateRegistry &registry, int max_expansions,
+    const ExpansionCallback &expand,
+    utils::RandomNumberGenerator *rng = nullptr);
+
+// Returns num_states random (and possibly unreachable) states.
+extern std::vector<std::vector<int>> create_random_states(
+    const TaskProxy &task_proxy, int num_states, int seed = 2024);
+}
+
+#endif
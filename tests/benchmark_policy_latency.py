@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+
+"""
+Measures policy query throughput and time per test of pool_fuzzer and pool_policy_tester.
+By default, the policy is a simulated_remote_policy with configurable latency and jitter, so no policy server is
+needed; use --remote-policy to benchmark against a real policy server instead.
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import tempfile
+
+parser = argparse.ArgumentParser(description=__doc__)
+parser.add_argument('--engine', default='../builds/release/bin/downward')
+parser.add_argument('--instances', nargs='*', default=None,
+                    help='translated tasks (default: all tasks in sas/)')
+parser.add_argument('--policy', default='heuristic_descend_policy(eval=ff())',
+                    help='built-in policy answering the simulated queries')
+parser.add_argument('--latency', type=float, default=1.0, help='latency per query in milliseconds')
+parser.add_argument('--jitter', type=float, default=0.0, help='maximal jitter per query in milliseconds')
+parser.add_argument('--remote-policy', default=None, metavar='URL',
+                    help='benchmark the remote policy at URL instead of a simulated one')
+parser.add_argument('--oracle', default='bounded_lookahead_oracle()')
+parser.add_argument('--max-pool-size', type=int, default=100)
+args = parser.parse_args()
+
+if args.instances is None:
+    args.instances = [os.path.join('sas', name) for name in sorted(os.listdir('sas'))]
+
+if args.remote_policy:
+    policy_args = ['--remote-policy', args.remote_policy]
+    policy = ''
+else:
+    policy_args = ['--policy', f'pi=simulated_remote_policy(policy={args.policy}, latency={args.latency}, '
+                               f'jitter={args.jitter})']
+    policy = 'policy=pi, '
+
+
+def read_value(output, key):
+    match = re.search(rf'^{re.escape(key)}: ([0-9.e+-]+)', output, re.MULTILINE)
+    return float(match.group(1)) if match else None
+
+
+def run(instance, search_config):
+    call = [args.engine] + policy_args + ['--search', search_config]
+    if args.remote_policy:
+        # the remote policy provides the task
+        result = subprocess.run(call, capture_output=True)
+    else:
+        with open(instance, 'r') as input_file:
+            result = subprocess.run(call, stdin=input_file, capture_output=True)
+    output = result.stdout.decode()
+    testing_time = read_value(output, 'Testing time')
+    tests = read_value(output, 'Conducted tests')
+    return {
+        'queries': read_value(output, 'Policy queries'),
+        'queries/s': read_value(output, 'Policy queries per second'),
+        # only reported by simulated policies: time per query without the simulated latency
+        'overhead/query': read_value(output, 'Policy query overhead per query'),
+        'time/test': testing_time / tests if testing_time is not None and tests else None,
+        'total': read_value(output, 'Total time'),
+    }
+
+
+def print_result(instance, engine, result):
+    values = ', '.join(f'{key}={"n/a" if value is None else f"{value:.4g}"}' for key, value in result.items())
+    print(f'{instance} {engine}: {values}')
+
+
+with tempfile.TemporaryDirectory() as tmp_dir:
+    for instance in args.instances:
+        pool_file = os.path.join(tmp_dir, os.path.basename(instance) + '.pool')
+        print_result(instance, 'pool_fuzzer', run(
+            instance, f'pool_fuzzer({policy}max_pool_size={args.max_pool_size}, pool_file={pool_file}, '
+                      f'testing_method={args.oracle})'))
+        print_result(instance, 'pool_policy_tester', run(
+            instance, f'pool_policy_tester({policy}pool_file={pool_file}, testing_method={args.oracle})'))